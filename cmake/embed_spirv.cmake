@@ -0,0 +1,56 @@
+# ────────────────────────────────────────────────────────────────
+# 🛠️  Tucoff's Vulkan Sandbox — SPIR-V → cabeçalho C++
+#
+# Converte um arquivo .spv em um cabeçalho com um array 'constexpr uint32_t',
+# para que o executável carregue os shaders sem nenhuma leitura de arquivo.
+# Usado em modo script tanto pelo CMakeLists.txt quanto pelo Makefile:
+#
+#   cmake -DSPV_FILE=<entrada.spv> -DOUT_HEADER=<saida.h> -P embed_spirv.cmake
+#
+# O nome do símbolo vem da pasta e do nome do shader:
+#   1_triangle/shader.vert.spv  →  SPIRV_1_TRIANGLE_SHADER_VERT
+# ────────────────────────────────────────────────────────────────
+
+if(NOT SPV_FILE OR NOT OUT_HEADER)
+    message(FATAL_ERROR "Uso: cmake -DSPV_FILE=<arquivo.spv> -DOUT_HEADER=<arquivo.h> -P embed_spirv.cmake")
+endif()
+
+# Montar o nome do símbolo a partir da pasta do projeto e do nome do shader
+get_filename_component(SPV_NAME "${SPV_FILE}" NAME)
+get_filename_component(SPV_DIR "${SPV_FILE}" DIRECTORY)
+get_filename_component(SPV_DIR_NAME "${SPV_DIR}" NAME)
+string(REGEX REPLACE "\\.spv$" "" SPV_STEM "${SPV_NAME}")
+string(MAKE_C_IDENTIFIER "SPIRV_${SPV_DIR_NAME}_${SPV_STEM}" SYMBOL)
+string(TOUPPER "${SYMBOL}" SYMBOL)
+
+# Ler o binário como hexadecimal (2 caracteres por byte)
+file(READ "${SPV_FILE}" SPV_HEX HEX)
+string(LENGTH "${SPV_HEX}" SPV_HEX_LENGTH)
+math(EXPR SPV_REMAINDER "${SPV_HEX_LENGTH} % 8")
+if(SPV_HEX_LENGTH EQUAL 0 OR NOT SPV_REMAINDER EQUAL 0)
+    message(FATAL_ERROR "${SPV_FILE} não é um SPIR-V válido (o tamanho deve ser múltiplo de 4 bytes)")
+endif()
+
+# SPIR-V é little-endian: cada grupo de 4 bytes vira uma palavra 0xb3b2b1b0.
+# Processar 8 palavras (64 caracteres hex) por linha para o cabeçalho continuar legível.
+set(SPV_WORDS "")
+set(SPV_POSITION 0)
+while(SPV_POSITION LESS SPV_HEX_LENGTH)
+    string(SUBSTRING "${SPV_HEX}" ${SPV_POSITION} 64 SPV_LINE_HEX)
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1u, " SPV_LINE "${SPV_LINE_HEX}")
+    string(STRIP "${SPV_LINE}" SPV_LINE)
+    string(APPEND SPV_WORDS "    ${SPV_LINE}\n")
+    math(EXPR SPV_POSITION "${SPV_POSITION} + 64")
+endwhile()
+
+file(WRITE "${OUT_HEADER}"
+"// Gerado por cmake/embed_spirv.cmake a partir de ${SPV_NAME} — não edite.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+alignas(4) constexpr uint32_t ${SYMBOL}[] = {
+${SPV_WORDS}};
+constexpr size_t ${SYMBOL}_SIZE = sizeof(${SYMBOL}); // Tamanho em bytes (VkShaderModuleCreateInfo::codeSize)
+")
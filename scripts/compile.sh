@@ -1,4 +1,10 @@
 #!/bin/bash
-GLSLC=/usr/bin/glslc
-$GLSLC shaders/1_triangle/shader.vert -o shaders/1_triangle/vert.spv
-$GLSLC shaders/1_triangle/shader.frag -o shaders/1_triangle/frag.spv
\ No newline at end of file
+# Compiles every shader under shaders/*/ to <name>.<stage>.spv next to its source, the names the embedded headers,
+# createShaderModule and scripts/pack_shaders.py use (e.g. shaders/1_triangle/shader.vert.spv).
+# Usage: scripts/compile.sh (from the repository root), then python3 scripts/pack_shaders.py to build shaders.pak.
+set -e
+GLSLC=${GLSLC:-glslc}
+for shader in shaders/*/*.vert shaders/*/*.frag shaders/*/*.comp; do
+    [ -e "$shader" ] || continue
+    $GLSLC "$shader" -o "$shader.spv"
+done
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+# Writes a mesh file read by src/mesh_file.cpp: a grid of quads in the triangle demo's vertex layout
+# (vec2 position + vec3 color, vertex format 1). Indices are 16-bit when they fit, 32-bit otherwise.
+# The grid is written in authored order; run the cook tool (tools/cook_mesh.cpp) on it to reorder it for the GPU.
+# Usage: python3 scripts/make_mesh.py [cells_per_side] [output.bin] && cook_mesh output.bin output.bin
+import struct
+import sys
+
+MAGIC = b"VMSH"
+VERSION = 1
+VERTEX_FORMAT_POS2_COLOR3 = 1
+VERTEX_STRIDE = 20  # 5 floats; must match sizeof(Vertex) (pinned by a static_assert in epic_triangle.cpp).
+BLOB_ALIGNMENT = 64
+HEADER_FORMAT = "<4sIIIIIIIQQQQ"  # Must match MeshFileHeader (64 bytes).
+
+cells = int(sys.argv[1]) if len(sys.argv) > 1 else 1
+output_path = sys.argv[2] if len(sys.argv) > 2 else "mesh.bin"
+
+side = cells + 1
+vertices = bytearray()
+for y in range(side):
+    for x in range(side):
+        u, v = x / cells, y / cells
+        vertices += struct.pack("<5f", u - 0.5, v - 0.5, u, v, 1.0 - u)
+
+index_list = []
+for y in range(cells):
+    for x in range(cells):
+        i = y * side + x
+        index_list += [i, i + 1, i + side + 1, i, i + side + 1, i + side]
+
+index_size = 2 if side * side <= 0x10000 else 4
+indices = struct.pack(f"<{len(index_list)}{'H' if index_size == 2 else 'I'}", *index_list)
+
+
+def align(offset):
+    return (offset + BLOB_ALIGNMENT - 1) // BLOB_ALIGNMENT * BLOB_ALIGNMENT
+
+
+header_size = struct.calcsize(HEADER_FORMAT)
+vertex_offset = align(header_size)
+index_offset = align(vertex_offset + len(vertices))
+header = struct.pack(HEADER_FORMAT, MAGIC, VERSION, VERTEX_FORMAT_POS2_COLOR3, VERTEX_STRIDE, side * side,
+                     index_size, len(index_list), 0, vertex_offset, len(vertices), index_offset, len(indices))
+
+with open(output_path, "wb") as f:
+    f.write(header)
+    f.write(b"\0" * (vertex_offset - header_size))
+    f.write(vertices)
+    f.write(b"\0" * (index_offset - vertex_offset - len(vertices)))
+    f.write(indices)
+
+print(f"Wrote {output_path}: {side * side} vertices, {len(index_list)} {index_size * 8}-bit indices")
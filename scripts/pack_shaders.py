@@ -0,0 +1,41 @@
+#!/usr/bin/env python3
+# Writes the compiled shaders (*.spv under shaders/) into a single shader pack read by src/shader_pack.cpp.
+# Usage: python3 scripts/pack_shaders.py [shaders_dir] [output.pak]
+import os
+import struct
+import sys
+
+MAGIC = b"SPK1"
+NAME_SIZE = 56
+ENTRY_SIZE = NAME_SIZE + 8
+
+shader_dir = sys.argv[1] if len(sys.argv) > 1 else "shaders"
+output_path = sys.argv[2] if len(sys.argv) > 2 else "shaders.pak"
+
+blobs = []
+for root, _, files in os.walk(shader_dir):
+    for file_name in sorted(files):
+        if not file_name.endswith(".spv"):
+            continue
+        path = os.path.join(root, file_name)
+        name = os.path.relpath(path, shader_dir).replace(os.sep, "/").encode()
+        if len(name) >= NAME_SIZE:
+            sys.exit(f"shader name too long for the pack: {name.decode()}")
+        with open(path, "rb") as f:
+            code = f.read()
+        if len(code) % 4 != 0:
+            sys.exit(f"{path} is not a SPIR-V binary (size is not a multiple of 4)")
+        blobs.append((name, code))
+
+blobs.sort()
+offset = 8 + ENTRY_SIZE * len(blobs)  # Already 4-byte aligned, and every blob size is a multiple of 4.
+table = b""
+data = b""
+for name, code in blobs:
+    table += struct.pack(f"<{NAME_SIZE}sII", name, offset + len(data), len(code))
+    data += code
+
+with open(output_path, "wb") as f:
+    f.write(MAGIC + struct.pack("<I", len(blobs)) + table + data)
+
+print(f"Packed {len(blobs)} shaders into {output_path}")
@@ -0,0 +1,46 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Every storage buffer of the bindless set, read as raw vec4s
+layout(set = 0, binding = 0) readonly buffer BindlessBuffer
+{
+    vec4 data[];
+} buffers[];
+
+// Selects the resources of the draw; the same for every vertex, so the array index is dynamically uniform
+layout(push_constant) uniform PushConstants
+{
+    uint objectBuffer;  // Slot of the uniform arena in buffers[]
+    uint firstObject;   // vec4 index of the first UniformBufferObject of the draw
+    uint objectStride;  // vec4s between two consecutive UniformBufferObjects
+} push;
+
+// Snorm16 positions are stored divided by the mesh extent (1.0 for float and half positions)
+layout(constant_id = 2) const float POSITION_SCALE = 1.0;
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec3 inColor;
+
+layout(location = 0) out vec3 fragColor;
+
+// The depth pre-pass and the color subpass compile this shader into different pipelines; both must produce the same depth
+invariant gl_Position;
+
+// Reads the column-major matrix starting at a vec4 index of the arena
+mat4 loadMatrix(uint index)
+{
+    return mat4(buffers[push.objectBuffer].data[index + 0], buffers[push.objectBuffer].data[index + 1],
+                buffers[push.objectBuffer].data[index + 2], buffers[push.objectBuffer].data[index + 3]);
+}
+
+void main()
+{
+    // One merged draw covers every visible object: the instance index selects its entry (model, view, proj)
+    uint object = push.firstObject + uint(gl_InstanceIndex) * push.objectStride;
+    mat4 model = loadMatrix(object + 0);
+    mat4 view = loadMatrix(object + 4);
+    mat4 proj = loadMatrix(object + 8);
+
+    gl_Position = proj * view * model * vec4(inPosition * POSITION_SCALE, 0.0, 1.0);
+    fragColor = inColor;
+}
@@ -0,0 +1,34 @@
+#version 450
+
+layout(binding = 0) uniform UniformBufferObject 
+{
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+// Snorm16 positions are stored divided by the mesh extent (1.0 for float and half positions)
+layout(constant_id = 2) const float POSITION_SCALE = 1.0;
+
+// Binding 0, per vertex
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec3 inColor;
+
+// Binding 1, per instance (InstanceData)
+layout(location = 2) in vec4 inTransform; // xy: center, z: scale, w: rotation in radians
+layout(location = 3) in vec4 inTint;
+
+layout(location = 0) out vec3 fragColor;
+
+// The depth pre-pass and the color subpass compile this shader into different pipelines; both must produce the same depth
+invariant gl_Position;
+
+void main() 
+{
+    float c = cos(inTransform.w);
+    float s = sin(inTransform.w);
+    vec2 position = mat2(c, s, -s, c) * (inPosition * POSITION_SCALE) * inTransform.z + inTransform.xy;
+
+    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(position, 0.0, 1.0);
+    fragColor = inColor * inTint.rgb;
+}
\ No newline at end of file
@@ -1,10 +1,14 @@
 #version 450
 
+// Set per pipeline permutation (see PipelineBuilder)
+layout(constant_id = 0) const float COLOR_SCALE = 1.0;
+layout(constant_id = 1) const float ALPHA = 1.0;
+
 layout(location = 0) in vec3 fragColor;
 
 layout(location = 0) out vec4 outColor;
 
 void main() 
 {
-    outColor = vec4(fragColor, 1.0);
+    outColor = vec4(fragColor * COLOR_SCALE, ALPHA);
 }
\ No newline at end of file
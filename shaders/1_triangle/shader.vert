@@ -7,13 +7,19 @@ layout(binding = 0) uniform UniformBufferObject
     mat4 proj;
 } ubo;
 
+// Snorm16 positions are stored divided by the mesh extent (1.0 for float and half positions)
+layout(constant_id = 2) const float POSITION_SCALE = 1.0;
+
 layout(location = 0) in vec2 inPosition;
 layout(location = 1) in vec3 inColor;
 
 layout(location = 0) out vec3 fragColor;
 
+// The depth pre-pass and the color subpass compile this shader into different pipelines; both must produce the same depth
+invariant gl_Position;
+
 void main() 
 {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 0.0, 1.0);
+    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition * POSITION_SCALE, 0.0, 1.0);
     fragColor = inColor;
 }
@@ -7,6 +7,27 @@
 // epic_triangle.cpp
 #include "epic_triangle.h"              // Include the header file for this module
 #include "utils.h"                      // Include the header file for this module
+#include "memory_allocator.h"           // Include the sub-allocating device memory allocator
+#include "upload_manager.h"             // Include the asynchronous upload manager
+#include "uniform_ring.h"               // Include the dynamic-offset uniform arena
+#include "thread_pool.h"                // Include the worker threads used for parallel command recording
+#include "pipeline_cache.h"             // Include the on-disk pipeline cache
+#include "shader_pack.h"                // Include the memory-mapped external shader pack
+#include "pipeline_builder.h"           // Include the parallel pipeline permutation builder
+#include "mesh_file.h"                  // Include the memory-mapped binary mesh loader
+#include "vertex_format.h"              // Include the quantized vertex formats and their packing kernels
+#include "frustum_culler.h"             // Include the SIMD structure-of-arrays frustum culling
+#include "transform_hierarchy.h"        // Include the dirty-flag scene transform hierarchy
+#include "bindless_descriptors.h"       // Include the descriptor indexing resource set
+#include "gpu_profiler.h"               // Include the timestamp query pass timer
+#include "cpu_profiler.h"               // Include the scoped CPU zones (compiled out without ENABLE_CPU_PROFILER)
+#include "frame_stats.h"                // Include the lock-free frame statistics ring and its reader thread
+#include "shaders/1_triangle/shader.vert.spv.h" // SPIR-V of the vertex shader, embedded at build time
+#include "shaders/1_triangle/shader.frag.spv.h" // SPIR-V of the fragment shader, embedded at build time
+#include "shaders/1_triangle/instanced.vert.spv.h" // SPIR-V of the instanced vertex shader, embedded at build time
+#include "shaders/1_triangle/bindless.vert.spv.h" // SPIR-V of the vertex shader reading its objects through the bindless set
+#include "shaders/1_triangle/cull.comp.spv.h"   // SPIR-V of the compute shader that builds the GPU-driven draw
+#include "shaders/1_triangle/overlay.vert.spv.h" // SPIR-V of the vertex shader of the frame statistics overlay
 
 #if defined(_WIN32) || defined(_WIN64)  // Check if the platform is Windows
     #define VK_USE_PLATFORM_WIN32_KHR
@@ -26,7 +47,6 @@
 #include <chrono>                           // For using std::chrono for timing operations
 #include <array>                            // For using std::array (fixed-size arrays)
 #include <iostream>                         // For standard input/output operations (e.g., std::cerr)
-#include <fstream>                          // For file stream operations (not used in this code, but often included for file I/O)
 #include <stdexcept>                        // For standard exception handling (e.g., std::runtime_error)
 #include <vector>                           // For using std::vector dynamic arrays
 #include <cstring>                          // For C-style string manipulation (e.g., strcmp)
@@ -36,6 +56,10 @@
 #include <cstdint>                          // Necessary for uint32_t
 #include <limits>                           // Necessary for std::numeric_limits
 #include <algorithm>                        // Necessary for std::clamp
+#include <string>                           // For building the window title
+#include <random>                           // For placing the objects of the culling benchmark
+#include <cmath>                            // For std::sin / std::cos / std::sqrt
+#include <fstream>                          // For writing the headless readback image
 
 #pragma endregion
 
@@ -45,13 +69,54 @@
 
 // Define the application name
 const char* APP_NAME = "Triangulo"; // Application name, means "Triangle" in Portuguese (PT-BR)
-// Define the width of the application window
+// Define the default width of the application window (--width)
 const uint32_t WIDTH = 1280;
-// Define the height of the application window
+// Define the default height of the application window (--height)
 const uint32_t HEIGHT = 720;
 
 // Maximum number of frames that can be in flight (processed concurrently)
 const int MAX_FRAMES_IN_FLIGHT = 4;
+// Number of frames in flight at startup (changed at runtime with the keys 1 to 4)
+const uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+
+// Maximum number of per-object uniform entries that can be written in a single frame
+const uint32_t MAX_UNIFORM_OBJECTS = 4096;
+// Side of the grid of quads drawn every frame (one draw call per quad)
+const uint32_t SCENE_GRID_SIZE = 32;
+// Side of the grid of quads drawn by the instanced path (a single draw call, 102400 instances)
+const uint32_t INSTANCE_GRID_SIZE = 320;
+// Objects culled every frame by the CPU culling benchmark (toggled with K)
+const uint32_t CULL_BENCHMARK_OBJECTS = 1 << 20;
+
+// File the pipeline cache is persisted to, and how often (in seconds) it is saved while running
+const char* const PIPELINE_CACHE_FILE = "pipeline_cache.bin";
+const double PIPELINE_CACHE_SAVE_INTERVAL = 30.0;
+
+// Optional shader pack (scripts/pack_shaders.py); shaders found in it override the embedded SPIR-V
+const char* const SHADER_PACK_FILE = "shaders.pak";
+
+// Frames rendered by a headless run when no frame count is given
+const uint32_t HEADLESS_DEFAULT_FRAMES = 100;
+// Format of the offscreen color images of the headless mode (written to the readback file in this byte order)
+const VkFormat HEADLESS_COLOR_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+
+// Optional mesh file (scripts/make_mesh.py, optimized by tools/cook_mesh.cpp) replacing the built-in quad
+const char* const MESH_FILE = "mesh.bin";
+// Size of the storage buffer and texture arrays of the bindless descriptor set
+const uint32_t BINDLESS_MAX_BUFFERS = 1024;
+const uint32_t BINDLESS_MAX_TEXTURES = 1024;
+// File the CPU zones are written to at exit (Chrome trace-event JSON, only with ENABLE_CPU_PROFILER)
+const char* const CPU_TRACE_FILE = "cpu_trace.json";
+// Passes the GPU profiler can time in one command buffer
+const uint32_t GPU_PROFILER_MAX_PASSES = 8;
+// Frame statistics overlay (H key): per metric a background, FRAME_STATS_BINS histogram bars and a p99 marker,
+// all drawn as two triangles each in a single draw
+const uint32_t OVERLAY_QUADS_PER_METRIC = FRAME_STATS_BINS + 2;
+const uint32_t OVERLAY_VERTEX_COUNT = FRAME_METRIC_COUNT * OVERLAY_QUADS_PER_METRIC * 6;
+
+// Compact layout the vertices are packed into at load time (float32 is used if the device lacks the formats)
+const PositionEncoding VERTEX_POSITION_ENCODING = PositionEncoding::Snorm16;
+const ColorEncoding VERTEX_COLOR_ENCODING = ColorEncoding::Unorm8;
 
 // A vector of C-style strings containing the names of Vulkan validation layers to enable.
 // These layers provide debugging and error checking for Vulkan API usage.
@@ -87,6 +152,7 @@ struct QueueFamilyIndices
 {
     std::optional<uint32_t> graphicsFamily; // Index of the queue family that supports graphics operations.
     std::optional<uint32_t> presentFamily; // Index of the queue family that supports presenting images to a surface (e.g., window).
+    std::optional<uint32_t> transferFamily; // Index of the queue family used for uploads (a transfer-only family when the GPU has one).
 
     // Checks if all required queue families have been found.
     bool isComplete()
@@ -103,12 +169,92 @@ struct SwapChainSupportDetails
     std::vector<VkPresentModeKHR> presentModes;
 };
 
+// Everything the CPU touches while a single frame is in flight.
+// A frame slot is only reused after its fence has signaled, so all of its resources can be rewritten without further sync.
+struct FrameContext
+{
+    VkCommandPool commandPool = VK_NULL_HANDLE;             // Pool owned by this frame; its buffers are only reset once the frame's fence has signaled.
+    std::vector<VkCommandBuffer> commandBuffers;            // Cached primary command buffers of this frame, one per swap chain image.
+    std::vector<uint64_t> recordedGenerations;              // Command buffer generation each cached buffer was recorded with (0 = never).
+    std::vector<uint32_t> recordedUniformOffsets;           // Dynamic uniform offset baked into each cached buffer.
+    VkSemaphore imageAvailableSemaphore = VK_NULL_HANDLE;   // Signaled when the acquired swap chain image is ready.
+    VkFence inFlightFence = VK_NULL_HANDLE;                 // Signaled when the GPU has finished this frame.
+    uint32_t uniformRegion = 0;                             // Region (slice) of the uniform ring written by this frame.
+    std::vector<VkCommandPool> workerCommandPools;          // One pool per recording slice, only touched by the task recording that slice.
+    std::vector<std::vector<VkCommandBuffer>> secondaryCommandBuffers; // Secondary buffers per swap chain image, one per recording slice.
+};
+
+// An object of the draw list: one quad with its own model matrix.
+struct SceneObject
+{
+    glm::vec2 position; // Center of the quad in the XY plane.
+    float scale;        // Uniform scale of the quad.
+    float phase;        // Rotation offset in radians, so the quads do not spin in lockstep.
+    uint32_t transform; // Node in the scene transform hierarchy (a child of the grid node).
+};
+
+// How the scene is submitted (I selects the instanced path, G the GPU-driven one).
+enum class RenderPath
+{
+    DrawList,   // One vkCmdDrawIndexed and one uniform entry per scene object.
+    Instanced,  // The instance grid in one instanced draw; the CPU rewrites the instance data every frame.
+    GpuDriven,  // The instance grid culled and compacted by a compute pass, then drawn with one indirect draw.
+    Bindless    // The draw list as one merged draw; the shader finds each object through the bindless set and push constants.
+};
+
+// The pipelines of one render path (one vertex shader and layout), selectable at runtime.
+struct PathPipelines
+{
+    std::vector<std::shared_future<VkPipeline>> variants;          // In pipelineVariantNames order.
+    std::vector<std::shared_future<VkPipeline>> prePassVariants;   // Same variants testing against the depth pre-pass (no depth writes).
+    std::shared_future<VkPipeline> depthOnly;                      // Depth pre-pass pipeline (subpass 0).
+};
+
+// Per-instance data of the instanced path, read from vertex binding 1 (VK_VERTEX_INPUT_RATE_INSTANCE).
+// position, scale and rotation are contiguous so the shader reads them as one vec4.
+// It is also the object table entry of the GPU-driven path (ObjectData in cull.comp, same std430 layout).
+struct InstanceData
+{
+    glm::vec2 position; // Center of the quad in the XY plane.
+    float scale;        // Uniform scale of the quad.
+    float rotation;     // Rotation around Z in radians (rewritten every frame).
+    uint32_t color;     // RGBA8 tint multiplied with the vertex colors.
+    uint32_t padding;   // std430 rounds ObjectData up to the 8-byte alignment of its vec2.
+};
+static_assert(sizeof(InstanceData) == 24, "InstanceData must match ObjectData in cull.comp (24 bytes in std430)");
+static_assert(offsetof(InstanceData, position) == 0 && offsetof(InstanceData, scale) == 8 && offsetof(InstanceData, rotation) == 12 &&
+              offsetof(InstanceData, color) == 16, "InstanceData must match ObjectData in cull.comp (std430 offsets)");
+
 // A struct to represent the uniform buffer object (UBO) used in shaders.
 struct UniformBufferObject
 {
     alignas(16) glm::mat4 model; // Model matrix for transforming the triangle.
     alignas(16) glm::mat4 view;  // View matrix for camera position and orientation.
     alignas(16) glm::mat4 proj;  // Projection matrix for perspective or orthographic projection.
+    alignas(16) glm::vec4 animation; // x: seconds since start (read by the GPU-driven compute pass).
+};
+static_assert(sizeof(UniformBufferObject) % 16 == 0, "bindless.vert indexes UniformBufferObjects in vec4 units");
+
+// Push constants of bindless.vert: where the UniformBufferObjects of a merged draw are, in vec4 units.
+struct BindlessPushConstants
+{
+    uint32_t objectBuffer;  // Slot of the uniform arena in the bindless storage buffer array.
+    uint32_t firstObject;   // Entry of the first object (its dynamic offset / 16).
+    uint32_t objectStride;  // Distance between two entries (the arena stride / 16).
+};
+
+// Push constants of cull.comp.
+struct CullPushConstants
+{
+    uint32_t objectCount;   // Entries of the object table.
+    float meshRadius;       // Bounding circle of the unscaled mesh around its origin (scaled per object).
+};
+
+// A vertex of the frame statistics overlay (overlay.vert), already in normalized device coordinates.
+struct OverlayVertex
+{
+    float position[2];      // NDC: (-1, -1) is the top left corner.
+    float color[3];
 };
 
 # pragma endregion
@@ -117,43 +263,72 @@ struct UniformBufferObject
 // This section defines the vertex structure used for rendering the "triangle".
 # pragma region Vertex
 //Vertex structure for the triangle
+// Plain float arrays rather than glm vectors: GLM_FORCE_DEFAULT_ALIGNED_GENTYPES may pad glm::vec2 / vec3, and this
+// layout is the on-disk vertex format of mesh files (MESH_VERTEX_FORMAT_POS2_COLOR3, 20 bytes).
 struct Vertex
 {
-    glm::vec2 pos; // Position of the vertex in 2D space.
-    glm::vec3 color;    // Color of the vertex in RGB format.
+    float pos[2];   // Position of the vertex in 2D space.
+    float color[3]; // Color of the vertex in RGB format.
 
-    // Function to specify the attribute descriptions for the vertex structure.
-    static std::array<VkVertexInputAttributeDescription, 2> getAttributeDescriptions()
+    // Attribute descriptions of binding 0 for the vertex data packed in the given format (float32 matches this struct).
+    static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions(const VertexFormat& format)
     {
-        std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
-
-        // Position attribute
-        attributeDescriptions[0].binding = 0; // Binding index for the vertex data.
-        attributeDescriptions[0].location = 0; // Location in the shader.
-        attributeDescriptions[0].format = VK_FORMAT_R32G32_SFLOAT; // Format of the position data (2D float).
-        attributeDescriptions[0].offset = offsetof(Vertex, pos); // Offset in the vertex structure.
-
-        // Color attribute
-        attributeDescriptions[1].binding = 0; // Binding index for the vertex data.
-        attributeDescriptions[1].location = 1; // Location in the shader.
-        attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT; // Format of the color data (RGB float).
-        attributeDescriptions[1].offset = offsetof(Vertex, color); // Offset in the vertex structure.
-
-        return attributeDescriptions; // Return the array of attribute descriptions.
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+        format.appendAttributes(attributeDescriptions, 0); // Position at location 0, color at location 1.
+        return attributeDescriptions; // Return the attribute descriptions.
     }
 
-    // Function to specify the binding description for the vertex structure.
-    static VkVertexInputBindingDescription getBindingDescription()
+    // Function to specify the binding description for the vertex data packed in the given format.
+    static VkVertexInputBindingDescription getBindingDescription(const VertexFormat& format)
     {
         VkVertexInputBindingDescription bindingDescription{};
         bindingDescription.binding = 0; // Binding index for the vertex data.
-        bindingDescription.stride = sizeof(Vertex); // Size of each vertex in bytes.
+        bindingDescription.stride = format.getStride(); // Size of each packed vertex in bytes.
         bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX; // Data is per vertex.
 
         return bindingDescription; // Return the binding description.
     }
+
+    // Attribute descriptions of the instanced path: the per-vertex attributes plus the InstanceData fields of binding 1.
+    static std::vector<VkVertexInputAttributeDescription> getInstancedAttributeDescriptions(const VertexFormat& format)
+    {
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions = getAttributeDescriptions(format);
+        VkVertexInputAttributeDescription instanceAttribute{};
+
+        // Position, scale and rotation attribute (read as one vec4)
+        instanceAttribute.binding = 1; // Binding index for the instance data.
+        instanceAttribute.location = 2; // Location in the shader.
+        instanceAttribute.format = VK_FORMAT_R32G32B32A32_SFLOAT; // Center (2 floats), scale, rotation.
+        instanceAttribute.offset = offsetof(InstanceData, position); // Offset in the instance structure.
+        attributeDescriptions.push_back(instanceAttribute);
+
+        // Tint attribute
+        instanceAttribute.binding = 1; // Binding index for the instance data.
+        instanceAttribute.location = 3; // Location in the shader.
+        instanceAttribute.format = VK_FORMAT_R8G8B8A8_UNORM; // Four normalized bytes, read as a vec4.
+        instanceAttribute.offset = offsetof(InstanceData, color); // Offset in the instance structure.
+        attributeDescriptions.push_back(instanceAttribute);
+
+        return attributeDescriptions; // Return the attribute descriptions.
+    }
+
+    // Binding descriptions of the instanced path: binding 0 advances per vertex, binding 1 per instance.
+    static std::array<VkVertexInputBindingDescription, 2> getInstancedBindingDescriptions(const VertexFormat& format)
+    {
+        std::array<VkVertexInputBindingDescription, 2> bindingDescriptions{};
+        bindingDescriptions[0] = getBindingDescription(format);
+
+        bindingDescriptions[1].binding = 1; // Binding index for the instance data.
+        bindingDescriptions[1].stride = sizeof(InstanceData); // Size of each instance in bytes.
+        bindingDescriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE; // Data advances once per instance.
+
+        return bindingDescriptions; // Return the binding descriptions.
+    }
 };
 
+static_assert(sizeof(Vertex) == 5 * sizeof(float), "Vertex must match the 20-byte vertex format of mesh files");
+static_assert(offsetof(Vertex, pos) == 0 && offsetof(Vertex, color) == 2 * sizeof(float), "Vertex must match the vertex format of mesh files");
+
 // Vertices for the triangle
 const std::vector<Vertex> vertices = {
     {{0.5f, -0.5f}, {1.0f, 0.0f, 0.0f}}, // Top left vertex (red)
@@ -174,13 +349,31 @@ class HelloTriangleApplication
 {
 
 public:
+    // Stores the run options; a headless run without a frame count renders HEADLESS_DEFAULT_FRAMES frames.
+    explicit HelloTriangleApplication(const RunOptions& runOptions) : options(runOptions)
+    {
+        if (options.headless && options.frameCount == 0)
+        {
+            options.frameCount = HEADLESS_DEFAULT_FRAMES;
+        }
+        options.width = options.width != 0 ? options.width : WIDTH;
+        options.height = options.height != 0 ? options.height : HEIGHT;
+    }
+
     // The main entry point for the application.
     void run()
     {
-        initWindow();     // Initialize the GLFW window.
+        PROFILE_THREAD_NAME("main");
+        benchmark.start(options.warmupFrames); // Startup is measured from here to the first frame.
+        initWindow();     // Initialize the GLFW window (nothing in headless mode).
         initVulkan();     // Initialize Vulkan components.
+        benchmark.markStartupComplete();
+        memoryTelemetry.checkBudget(std::cerr); // Warn right away if the resources alone come close to the budget.
         mainLoop();       // Enter the main application loop.
+        benchmark.setPeakDeviceMemory(memoryTelemetry.getPeakDeviceMemoryBytes());
+        benchmark.writeReport("triangle", options, swapChainExtent.width, swapChainExtent.height, activePresentModeName);
         cleanup();        // Clean up Vulkan and GLFW resources.
+        PROFILE_WRITE_TRACE(CPU_TRACE_FILE); // Every zone of the run, including the initVulkan stages.
     }
 
 private:
@@ -189,7 +382,10 @@ private:
     // These variables are used to manage the Vulkan rendering pipeline and resources.
     # pragma region Private Member Variables
 
-    GLFWwindow* window = nullptr;                                   // Pointer to the GLFW window object.
+    RunOptions options;                                             // Run options (headless mode, frame counts, resolution, report).
+    BenchmarkRecorder benchmark;                                    // Startup and per-frame times of the run, reported at exit.
+    const char* activePresentModeName = "none";                     // Present mode of the swap chain, for the report.
+    GLFWwindow* window = nullptr;                                   // Pointer to the GLFW window object (nullptr in headless mode).
     VkInstance instance = VK_NULL_HANDLE;                           // Pointer to the GLFW window object.
     VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;       // Vulkan debug messenger object.
     VkSurfaceKHR surface = VK_NULL_HANDLE;                          // Vulkan surface for rendering to the window.
@@ -198,31 +394,138 @@ private:
     VkDevice device = VK_NULL_HANDLE;                               // Vulkan logical device object.
     VkQueue graphicsQueue = VK_NULL_HANDLE;                         // Handle to the graphics queue.
     VkQueue presentQueue = VK_NULL_HANDLE;                          // Handle to the present queue (for displaying images on the surface).
+    VkQueue transferQueue = VK_NULL_HANDLE;                         // Handle to the queue used for uploads (may be the graphics queue).
+    QueueFamilyIndices queueFamilies = {};                          // Queue families the logical device was created with.
     VkSwapchainKHR swapChain = VK_NULL_HANDLE;                      // Vulkan swap chain for managing images to be presented.
     std::vector<VkImage> swapChainImages = {};                      // Vector to hold the images in the swap chain.
     VkFormat swapChainImageFormat = VK_FORMAT_UNDEFINED;            // Format of the swap chain images.
     VkExtent2D swapChainExtent = {};                                // Extent (size) of the swap chain images.
     std::vector<VkImageView> swapChainImageViews = {};              // Vector to hold image views for the swap chain images.
+    std::vector<MemoryAllocation> offscreenImageAllocations;        // Headless mode: memory of the offscreen images standing in for the swap chain.
+    uint32_t lastImageIndex = 0;                                    // Image rendered by the last submitted frame (read back in headless mode).
+    uint32_t renderedFrameCount = 0;                                // Frames submitted since the start, checked against the warmup + measured frame count.
     VkRenderPass renderPass = VK_NULL_HANDLE;                       // Vulkan render pass object for rendering operations.
     VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;     // Vulkan descriptor set layout for uniform buffers.
     VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;               // Vulkan pipeline layout for the graphics pipeline.
-    VkPipeline graphicsPipeline = VK_NULL_HANDLE;                   // Vulkan graphics pipeline object for rendering.
+    VkPipeline graphicsPipeline = VK_NULL_HANDLE;                   // Pipeline currently used for rendering (owned by one of the builders).
+    VkShaderModule vertShaderModule = VK_NULL_HANDLE;               // Vertex shader shared by every pipeline variant.
+    VkShaderModule instancedVertShaderModule = VK_NULL_HANDLE;      // Vertex shader of the instanced variants.
+    VkShaderModule fragShaderModule = VK_NULL_HANDLE;               // Fragment shader shared by every pipeline variant.
+    VkShaderModule bindlessVertShaderModule = VK_NULL_HANDLE;       // Vertex shader of the bindless variants.
+    bool bindlessSupported = false;                                 // True if the descriptor indexing features were enabled on the device.
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = {}; // Features chained into the device create info.
+    BindlessDescriptorSet bindlessSet;                              // Update-after-bind set with every storage buffer and texture.
+    VkPipelineLayout bindlessPipelineLayout = VK_NULL_HANDLE;       // Bindless set plus the push constants selecting the objects.
+    uint32_t uniformArenaSlot = 0;                                  // Slot of the uniform arena in the bindless storage buffer array.
+    ThreadPool pipelineThreads;                                     // Workers compiling pipeline variants (separate from recordingThreads).
+    PipelineBuilder pipelineBuilder;                                // Compiles and owns the pipeline variants of the per-object path.
+    PipelineBuilder instancedPipelineBuilder;                       // Compiles and owns the pipeline variants of the instanced path.
+    PipelineBuilder bindlessPipelineBuilder;                        // Compiles and owns the pipeline variants of the bindless path.
+    PathPipelines drawListPipelines;                                // Pipelines of the draw list.
+    PathPipelines instancedPipelines;                               // Pipelines of the instanced and GPU-driven paths.
+    PathPipelines bindlessPipelines;                                // Pipelines of the bindless path (empty if it is not supported).
+    VkPipeline depthPrePassPipeline = VK_NULL_HANDLE;               // Pipeline drawing subpass 0, or VK_NULL_HANDLE while the pre-pass is off.
+    bool requestedDepthPrePass = false;                             // Toggled with Z (applied once the pipelines have compiled).
+    std::vector<const char*> pipelineVariantNames;                  // Display name of each variant.
+    size_t activePipelineVariant = 0;                               // Variant bound by the recorded command buffers.
+    size_t requestedPipelineVariant = 0;                            // Variant selected with the V key (applied once compiled).
+    RenderPath renderPath = RenderPath::DrawList;                   // How the scene is currently submitted.
+    RenderPath requestedRenderPath = RenderPath::DrawList;          // Selected with I / G / B (applied once the pipeline is compiled).
+    bool wireframeSupported = false;                                // True if fillModeNonSolid was enabled on the device.
     std::vector<VkFramebuffer> swapChainFramebuffers;               // Vector to hold framebuffers for the swap chain images.
-    VkCommandPool commandPool = VK_NULL_HANDLE;                     // Vulkan command pool for managing command buffers.
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;                     // Format of the depth attachment (see findDepthFormat).
+    VkImage depthImage = VK_NULL_HANDLE;                            // Depth buffer shared by every framebuffer, recreated with the swap chain.
+    MemoryAllocation depthImageAllocation = {};                     // Device-local memory of the depth buffer.
+    VkImageView depthImageView = VK_NULL_HANDLE;                    // View of the depth buffer (attachment 1 of every framebuffer).
+    bool overdrawCounterSupported = false;                          // True if pipelineStatisticsQuery was enabled on the device.
+    bool inheritedQueriesSupported = false;                         // True if secondary command buffers may run inside the query.
+    bool overdrawCounterEnabled = false;                            // Toggled with O; counts the fragment shader invocations of every frame.
+    VkQueryPool overdrawQueryPool = VK_NULL_HANDLE;                 // One pipeline statistics query per frame slot.
+    GpuProfiler gpuProfiler;                                        // Timestamps around the passes of every frame, per frame slot.
+    uint32_t cullGpuPass = 0;                                       // Profiler pass of the GPU-driven culling dispatch.
+    uint32_t renderGpuPass = 0;                                     // Profiler pass of the render pass (pre-pass and color subpass).
+    std::array<bool, MAX_FRAMES_IN_FLIGHT> overdrawQueryPending = {}; // The last submission of the slot ran its query.
+    FrameStatsCollector frameStats;                                 // Per-frame CPU / GPU / fence wait / latency samples, summarized on a reader thread.
+    FrameStatsSnapshot frameStatsSnapshot;                          // Last snapshot read from frameStats (kept while the reader publishes).
+    std::array<double, MAX_FRAMES_IN_FLIGHT> submittedFrameStarts = {}; // Per frame slot: start time of its last submitted frame (0 = none).
+    double lastFenceWaitMilliseconds = 0.0;                         // Fence wait of the last drawn frame.
+    double lastFrameLatencyMilliseconds = 0.0;                      // Start-to-completion time of the frame whose fence was just waited on.
+    bool frameStatsOverlayEnabled = false;                          // Toggled with H; draws the histograms of frameStats over the scene.
+    VkShaderModule overlayVertShaderModule = VK_NULL_HANDLE;        // Vertex shader of the overlay (the fragment shader is shared).
+    PipelineBuilder overlayPipelineBuilder;                         // Compiles and owns the overlay pipeline.
+    std::shared_future<VkPipeline> overlayPipelineBuild;            // Overlay pipeline, compiling on pipelineThreads.
+    VkPipeline overlayPipeline = VK_NULL_HANDLE;                    // Overlay pipeline once compiled (the overlay is skipped until then).
+    VkBuffer overlayVertexBuffer = VK_NULL_HANDLE;                  // Host-visible overlay quads, one region of OVERLAY_VERTEX_COUNT per frame in flight.
+    MemoryAllocation overlayVertexAllocation = {};                  // Persistently mapped memory of the overlay vertex buffer.
+    double overdrawAccumulator = 0.0;                               // Fragments per pixel summed over the current measurement window.
+    uint32_t overdrawSampleCount = 0;                               // Queries read in the current measurement window.
+    DeviceMemoryAllocator memoryAllocator;                          // Sub-allocator that hands out device memory from large blocks.
+    MemoryTelemetry memoryTelemetry;                                // Usage per heap, memory type and tag, checked against the heap budgets.
+    bool memoryBudgetSupported = false;                             // True if VK_EXT_memory_budget was enabled on the device.
+    UploadManager uploadManager;                                    // Batches buffer uploads on the transfer queue.
+    PipelineCache pipelineCache;                                    // Pipeline cache loaded from and saved to PIPELINE_CACHE_FILE.
+    double lastPipelineCacheSave = 0.0;                             // Time of the last periodic pipeline cache save.
+    ShaderPack shaderPack;                                          // External shader pack (stays closed when SHADER_PACK_FILE is absent).
+    UploadTicket geometryUpload = 0;                                // Ticket of the batch that uploads the vertex and index buffers.
+    bool geometryReady = false;                                     // True once the geometry upload has finished on the GPU.
     VkBuffer vertexBuffer = VK_NULL_HANDLE;                         // Vulkan buffer for storing vertex data.
-    VkDeviceMemory vertexBufferMemory = VK_NULL_HANDLE;             // Vulkan device memory for the vertex buffer.
+    MemoryAllocation vertexBufferAllocation = {};                   // Device memory sub-allocation for the vertex buffer.
     VkBuffer indexBuffer = VK_NULL_HANDLE;                          // Vulkan buffer for storing index data.
-    VkDeviceMemory indexBufferMemory = VK_NULL_HANDLE;              // Vulkan device memory for the index buffer.
+    MemoryAllocation indexBufferAllocation = {};                    // Device memory sub-allocation for the index buffer.
+    uint32_t indexCount = 0;                                        // Indices drawn per object (built-in quad or mesh file).
+    VkIndexType indexType = VK_INDEX_TYPE_UINT16;                   // Width of the indices in indexBuffer.
+    MeshFile meshFile;                                              // Mesh file mapping, open only while its blobs are staged.
+    VertexFormat vertexFormat;                                      // Layout the vertex buffer is packed in.
+    float positionScale = 1.0f;                                     // POSITION_SCALE specialization constant (mesh extent for snorm16).
     VkDescriptorPool descriptorPool = VK_NULL_HANDLE;               // Vulkan descriptor pool for allocating descriptor sets.
-    std::vector<VkBuffer> uniformBuffers;                           // Vector to hold uniform buffers for each swap chain image.
-    std::vector<VkDeviceMemory> uniformBuffersMemory;               // Vector to hold device memory for each uniform buffer.
-    std::vector<void*> uniformBuffersMapped;                        // Vector to hold mapped pointers for each uniform buffer.
-    std::vector<VkDescriptorSet> descriptorSets;                    // Vector to hold descriptor sets for each swap chain image.
-    std::vector<VkCommandBuffer> commandBuffers;                    // Vector to hold command buffers for recording rendering commands.
-    std::vector<VkSemaphore> imageAvailableSemaphores;              // Semaphores to signal when an image is available from the swap chain.
-    std::vector<VkSemaphore> renderFinishedSemaphores;              // Semaphores to signal when rendering is finished for a frame.
-    std::vector<VkFence> inFlightFences;                            // Fences to signal when a frame's rendering commands have finished executing.
+    UniformRing uniformRing;                                        // Persistently mapped arena holding every UniformBufferObject of every frame.
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;                 // The single dynamic uniform descriptor set, selected with dynamic offsets.
+    std::vector<FrameContext> frames;                               // Resources of each frame in flight.
+    std::vector<VkSemaphore> renderFinishedSemaphores;              // One per swap chain image: presentation may still hold it after the frame's fence signals.
+    uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT;             // Number of frames the CPU may run ahead of the GPU (1 to MAX_FRAMES_IN_FLIGHT).
+    uint32_t requestedFramesInFlight = 0;                           // Value selected with the number keys, applied between frames (0 = no change).
     uint32_t currentFrame = 0;                                      // Index of the current frame being processed.
+    double statsStartTime = 0.0;                                    // Start of the current frame-time measurement window.
+    uint32_t statsFrameCount = 0;                                   // Frames drawn in the current measurement window.
+    uint64_t commandBufferGeneration = 1;                           // Bumped whenever something baked into the command buffers changes.
+    uint64_t recordedFrameCount = 0;                                // Frames whose command buffer had to be recorded.
+    uint64_t reusedFrameCount = 0;                                  // Frames that submitted a cached command buffer without recording.
+    bool commandBufferCacheEnabled = true;                          // Toggled with C; when off every frame is recorded (to measure recording).
+    std::vector<SceneObject> sceneObjects;                          // Draw list: one draw call and one uniform entry per object.
+    float meshRadius = 0.0f;                                        // Largest distance of a mesh vertex from its origin (bounds of every object).
+    FrustumCuller sceneCuller;                                      // Bounding volumes of the draw list.
+    std::vector<uint32_t> visibleObjects;                           // Draw list indices that passed the last cull (first visibleObjectCount entries).
+    size_t visibleObjectCount = 0;                                  // Objects drawn this frame; uniform entry i belongs to visibleObjects[i].
+    TransformHierarchy sceneTransforms;                             // Grid node and one child node per draw list object.
+    uint32_t sceneRootNode = 0;                                     // Grid node: moving it would move every object.
+    glm::mat4 cameraView = glm::mat4(1.0f);                         // Cached camera matrices, rebuilt only when cameraExtent changes.
+    glm::mat4 cameraProjection = glm::mat4(1.0f);
+    glm::mat4 cameraViewProjection = glm::mat4(1.0f);               // proj * view, shared with the culling and the culling benchmark.
+    VkExtent2D cameraExtent = {0, 0};                               // Swap chain extent the camera matrices were built for.
+    FrustumCuller benchmarkCuller;                                  // CULL_BENCHMARK_OBJECTS random objects (filled when K is first pressed).
+    std::vector<uint32_t> benchmarkVisible;                         // Output of the benchmark cull.
+    bool cullBenchmarkEnabled = false;                              // Toggled with K; culls the benchmark set every frame.
+    double sphereCullTimeAccumulator = 0.0;                         // Seconds spent culling the benchmark spheres in the current window.
+    double boxCullTimeAccumulator = 0.0;                            // Seconds spent culling the benchmark boxes in the current window.
+    uint32_t cullTimeCount = 0;                                     // Benchmark culls in the current measurement window.
+    size_t benchmarkVisibleCount = 0;                               // Benchmark spheres that passed the last cull.
+    std::vector<InstanceData> instances;                            // Instance grid of the instanced path (rotation holds the phase).
+    VkBuffer instanceBuffer = VK_NULL_HANDLE;                       // Host-visible instance data, one region per frame in flight.
+    MemoryAllocation instanceBufferAllocation = {};                 // Persistently mapped memory of the instance buffer.
+    VkBuffer objectTableBuffer = VK_NULL_HANDLE;                    // Device-local copy of instances read by the culling pass.
+    MemoryAllocation objectTableAllocation = {};                    // Memory of the object table.
+    std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT> visibleInstanceBuffers = {}; // Per frame slot: instances that passed culling (vertex binding 1).
+    std::array<MemoryAllocation, MAX_FRAMES_IN_FLIGHT> visibleInstanceAllocations = {};
+    std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT> drawCommandBuffers = {};     // Per frame slot: the VkDrawIndexedIndirectCommand written by the culling pass.
+    std::array<MemoryAllocation, MAX_FRAMES_IN_FLIGHT> drawCommandAllocations = {};
+    VkDescriptorSetLayout cullDescriptorSetLayout = VK_NULL_HANDLE; // Uniform arena + object table + per-slot outputs.
+    VkPipelineLayout cullPipelineLayout = VK_NULL_HANDLE;           // Layout of the culling pass (object count and mesh radius as push constants).
+    VkPipeline cullPipeline = VK_NULL_HANDLE;                       // Compute pipeline running cull.comp.
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> cullDescriptorSets = {}; // One per frame slot (the outputs differ).
+    ThreadPool recordingThreads;                                    // Workers recording secondary command buffers.
+    bool parallelRecording = true;                                  // Toggled with P; records the draw list on the worker threads.
+    double recordTimeAccumulator = 0.0;                             // Seconds spent recording in the current measurement window.
+    uint32_t recordTimeCount = 0;                                   // Recordings in the current measurement window.
     bool framebufferResized = false;                                // Flag to indicate if the framebuffer has been resized.
 
     #pragma endregion
@@ -232,10 +535,18 @@ private:
     // Initializes the GLFW window.
     void initWindow()
     {
+        if (options.headless)
+        {
+            return; // Nothing is shown: GLFW is never initialized, so no display server is needed.
+        }
+
         #if defined(_WIN32) || defined(_WIN64)
             // No platform hint needed for Windows
         #elif defined(__linux__)
-            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_X11); // Set X11 platform for Linux
+            if (getenv("DISPLAY") != nullptr)
+            {
+                glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_X11); // Prefer X11 (or XWayland) when an X display is available
+            }
         #endif
         glfwInit(); // Initialize the GLFW library.
 
@@ -246,13 +557,56 @@ private:
         glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE); // Removed to allow resizing
 
         // Create the GLFW window with specified width, height, title, and no full-screen or sharing.
-        window = glfwCreateWindow(WIDTH, HEIGHT, APP_NAME, nullptr, nullptr);
+        window = glfwCreateWindow(static_cast<int>(options.width), static_cast<int>(options.height), APP_NAME, nullptr, nullptr);
 
         // Set the user pointer for the window to this HelloTriangleApplication instance,
         // allowing access to its members from static callbacks.
         glfwSetWindowUserPointer(window, this);
         // Set the callback function for framebuffer size changes.
         glfwSetFramebufferSizeCallback(window, framebufferResizeCallback);
+        // Set the callback function for keyboard input (frames in flight selection).
+        glfwSetKeyCallback(window, keyCallback);
+    }
+
+    // Static callback function for GLFW key events. The keys 1 to 4 select the number of frames in flight.
+    static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+        auto app = reinterpret_cast<HelloTriangleApplication*>(glfwGetWindowUserPointer(window));
+        if (action == GLFW_PRESS && key >= GLFW_KEY_1 && key <= GLFW_KEY_0 + MAX_FRAMES_IN_FLIGHT) {
+            app->requestedFramesInFlight = static_cast<uint32_t>(key - GLFW_KEY_0); // Applied by the main loop between frames.
+        }
+        if (action == GLFW_PRESS && key == GLFW_KEY_P) {
+            app->parallelRecording = !app->parallelRecording; // Switch between inline and secondary command buffer recording.
+            app->invalidateCommandBuffers();
+        }
+        if (action == GLFW_PRESS && key == GLFW_KEY_C) {
+            app->commandBufferCacheEnabled = !app->commandBufferCacheEnabled; // Force recording every frame to measure its cost.
+        }
+        if (action == GLFW_PRESS && key == GLFW_KEY_V && !app->drawListPipelines.variants.empty()) {
+            app->requestedPipelineVariant = (app->requestedPipelineVariant + 1) % app->drawListPipelines.variants.size(); // Applied once it has compiled.
+        }
+        if (action == GLFW_PRESS && key == GLFW_KEY_I) {
+            app->requestedRenderPath = app->requestedRenderPath == RenderPath::Instanced ? RenderPath::DrawList : RenderPath::Instanced; // Switch between the draw list and one instanced draw.
+        }
+        if (action == GLFW_PRESS && key == GLFW_KEY_G) {
+            app->requestedRenderPath = app->requestedRenderPath == RenderPath::GpuDriven ? RenderPath::DrawList : RenderPath::GpuDriven; // Switch between the draw list and the GPU-driven draw.
+        }
+        if (action == GLFW_PRESS && key == GLFW_KEY_B && app->bindlessSupported) {
+            app->requestedRenderPath = app->requestedRenderPath == RenderPath::Bindless ? RenderPath::DrawList : RenderPath::Bindless; // Switch between per-draw binds and one bindless draw.
+        }
+        if (action == GLFW_PRESS && key == GLFW_KEY_Z) {
+            app->requestedDepthPrePass = !app->requestedDepthPrePass; // Lay down the depth in subpass 0 before shading (applied once compiled).
+        }
+        if (action == GLFW_PRESS && key == GLFW_KEY_O) {
+            app->overdrawCounterEnabled = !app->overdrawCounterEnabled; // Count the fragments shaded per pixel.
+            app->invalidateCommandBuffers(); // The query is recorded into the cached command buffers.
+        }
+        if (action == GLFW_PRESS && key == GLFW_KEY_K) {
+            app->cullBenchmarkEnabled = !app->cullBenchmarkEnabled; // Time the CPU culling of CULL_BENCHMARK_OBJECTS objects every frame.
+        }
+        if (action == GLFW_PRESS && key == GLFW_KEY_H) {
+            app->frameStatsOverlayEnabled = !app->frameStatsOverlayEnabled; // Show the frame time histograms over the scene.
+            app->invalidateCommandBuffers(); // The overlay draw is recorded into the cached command buffers.
+        }
     }
 
     // Static callback function for GLFW framebuffer resize events.
@@ -270,30 +624,50 @@ private:
     // Initializes Vulkan components.
     void initVulkan()
     {
+        PROFILE_FUNCTION();
         createInstance();            // Create the Vulkan instance.
         setupDebugMessenger();       // Set up the debug messenger for validation layers.
         createSurface();             // Create a Vulkan surface for rendering.
         pickPhysicalDevice();        // Select a suitable physical device (GPU).
         createLogicalDevice();       // Create the logical device.
+        createMemoryAllocator();     // Create the device memory allocator.
+        createUploadManager();       // Create the upload manager on the transfer queue.
+        createPipelineCache();       // Load the pipeline cache saved by the previous run.
+        loadShaderPack();            // Map the external shader pack, if there is one.
+        loadMesh();                  // Map the mesh file, if there is one.
+        chooseVertexFormat();        // Pick the packed vertex layout the pipelines are built for.
         createSwapChain();           // Create the swap chain for presenting images to the surface.
         createImageViews();          // Create image views for the swap chain images.
+        createDepthResources();      // Create the depth buffer.
         createRenderPass();          // Create the render pass.
         createDescriptorSetLayout(); // Create the descriptor set layout.
-        createGraphicsPipeline();    // Create the graphics pipeline
+        createBindlessDescriptorSet(); // Create the bindless resource set, if descriptor indexing is supported.
+        createPipelineThreads();     // Start the worker threads that compile pipeline variants.
+        createGraphicsPipeline();    // Create the graphics pipeline and queue the other variants.
         createFramebuffers();        // Create the framebuffer
-        createCommandPool();         // Create the command pool for command buffers.
         createVertexBuffer();       // Create the vertex buffer for the triangle.
         createIndexBuffer();        // Create the index buffer for indexed drawing.
+        createSceneObjects();       // Fill the draw list (its bounds are measured on the mesh).
+        meshFile.close();           // Both blobs were copied into staging memory.
+        createInstanceBuffer();     // Fill the instance grid and create its per-frame buffer.
+        createGpuDrivenBuffers();   // Upload the object table and create the buffers written by the culling pass.
+        geometryUpload = uploadManager.submit(); // Send both uploads in one batch; the render loop polls the ticket.
         createUniformBuffers();     // Create uniform buffers for passing data to shaders.
         createDescriptorPool();     // Create the descriptor pool.
         createDescriptorSets();     // Create descriptor sets for binding uniform buffers.
-        createCommandBuffers();     // Create command buffers for rendering commands.
-        createSyncObjects();        // Create synchronization objects (semaphores and fences).
+        createCullPipeline();       // Create the compute pass that builds the GPU-driven draw.
+        createRecordingThreads();   // Start the worker threads that record secondary command buffers.
+        createFrameContexts();      // Create the command pool, command buffer and sync objects of each frame in flight.
+        createPresentSemaphores();  // Create the render finished semaphore of each swap chain image.
+        createOverdrawQueryPool();  // Create the fragment counters of the overdraw mode.
+        createGpuProfiler();        // Create the timestamp queries of the GPU pass timer.
+        createFrameStats();         // Start the frame statistics reader and queue the overlay pipeline.
     }
 
     // Creates the Vulkan instance.
     void createInstance()
     {
+        PROFILE_FUNCTION();
         // Check if validation layers are requested but not supported by the system.
         if (enableValidationLayers && !checkValidationLayerSupport())
         {
@@ -307,7 +681,7 @@ private:
         appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);  // Application version (1.0.0).
         appInfo.pEngineName = "LXXIV";                          // Name of the engine, yeah its a me reference.
         appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);       // Engine version (1.0.0).
-        appInfo.apiVersion = VK_API_VERSION_1_0;                // Vulkan API version used.
+        appInfo.apiVersion = VK_API_VERSION_1_1;                // Vulkan API version used (1.1 for vkGetPhysicalDeviceFeatures2).
 
         // Populate instance creation information.
         VkInstanceCreateInfo createInfo{};
@@ -385,13 +759,15 @@ private:
     // Retrieves the list of required Vulkan instance extensions.
     std::vector<const char*> getRequiredExtensions()
     {
-        uint32_t glfwExtensionCount = 0;
-        const char** glfwExtensions;
-        // Get the extensions required by GLFW for window surface creation.
-        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-        // Create a vector from the GLFW required extensions.
-        std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        // Headless mode creates no surface, so it needs no WSI extension (software drivers may not offer one).
+        std::vector<const char*> extensions;
+        if (!options.headless)
+        {
+            uint32_t glfwExtensionCount = 0;
+            // Get the extensions required by GLFW for window surface creation.
+            const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
         // If validation layers are enabled, add the debug utility extension.
         if (enableValidationLayers)
@@ -437,6 +813,7 @@ private:
     // Sets up the debug messenger for Vulkan validation layers.
     void setupDebugMessenger()
     {
+        PROFILE_FUNCTION();
         // If validation layers are not enabled, return early.
         if (!enableValidationLayers) return;
 
@@ -454,6 +831,12 @@ private:
     // Creates a Vulkan surface for rendering to the GLFW window.
     void createSurface() 
     {
+        PROFILE_FUNCTION();
+        if (options.headless)
+        {
+            return; // Rendering goes to offscreen images.
+        }
+
         // Check if the GLFW window is valid before creating the surface.
         if (glfwCreateWindowSurface(instance, window, nullptr, &surface) != VK_SUCCESS) 
         {
@@ -464,6 +847,7 @@ private:
     // Selects a suitable physical device (GPU) for Vulkan operations.
     void pickPhysicalDevice()
     {
+        PROFILE_FUNCTION();
         uint32_t deviceCount = 0;
         // Query the number of available physical devices.
         vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
@@ -506,9 +890,9 @@ private:
         QueueFamilyIndices indices = findQueueFamilies(device); // Find the queue families supported by the device.
         bool extensionsSupported = checkDeviceExtensionSupport(device); // Check if the required device extensions are supported.
 
-        // Check if the swap chain is adequate for the device.
-        bool swapChainAdequate = false;
-        if (extensionsSupported)
+        // Check if the swap chain is adequate for the device (headless mode has no swap chain).
+        bool swapChainAdequate = options.headless;
+        if (extensionsSupported && !options.headless)
         {
             SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device);
             swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
@@ -526,6 +910,12 @@ private:
         return indices.isComplete() && extensionsSupported && swapChainAdequate; // && requiredFeaturesSupported;
     }
 
+    // Device extensions the device must support: the swap chain, unless nothing is presented.
+    std::vector<const char*> getRequiredDeviceExtensions()
+    {
+        return options.headless ? std::vector<const char*>() : deviceExtensions;
+    }
+
     // Checks if the required Vulkan validation layers are supported by the system.
     bool checkDeviceExtensionSupport(VkPhysicalDevice device)
     {
@@ -539,7 +929,8 @@ private:
         // Get the properties of all available device extensions.
         vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
         // Create a set from the required device extensions for easy lookup.
-        std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
+        std::vector<const char*> requiredDeviceExtensions = getRequiredDeviceExtensions();
+        std::set<std::string> requiredExtensions(requiredDeviceExtensions.begin(), requiredDeviceExtensions.end());
         // Iterate through each available extension.
         for (const auto& extension : availableExtensions)
         {
@@ -549,16 +940,35 @@ private:
         return requiredExtensions.empty();
     }
 
+    // Checks if the selected physical device supports an optional device extension.
+    bool isDeviceExtensionSupported(const char* name)
+    {
+        uint32_t extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+        for (const auto& extension : availableExtensions)
+        {
+            if (strcmp(extension.extensionName, name) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
     // Creates the Vulkan logical device.
     void createLogicalDevice()
     {
-        // Find the required queue families (e.g., graphics queue).
-        QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
+        PROFILE_FUNCTION();
+        // Find the required queue families (e.g., graphics queue) once; everything created later reuses them.
+        queueFamilies = findQueueFamilies(physicalDevice);
+        const QueueFamilyIndices& indices = queueFamilies;
 
         // Create a vector to hold queue creation info structures
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
         // Use a set to ensure unique queue family indices (graphics and present)
-        std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value() };
+        std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value(), indices.transferFamily.value() };
 
         float queuePriority = 1.0f;
         // For each unique queue family, fill out the queue creation info
@@ -571,7 +981,33 @@ private:
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+
         VkPhysicalDeviceFeatures enabledFeatures = {};
+        enabledFeatures.fillModeNonSolid = supportedFeatures.fillModeNonSolid; // Needed by the wireframe pipeline variant.
+        wireframeSupported = supportedFeatures.fillModeNonSolid == VK_TRUE;
+        enabledFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery; // Needed by the overdraw counter.
+        enabledFeatures.inheritedQueries = supportedFeatures.inheritedQueries; // Lets the counter run around the secondary command buffers.
+        overdrawCounterSupported = supportedFeatures.pipelineStatisticsQuery == VK_TRUE;
+        inheritedQueriesSupported = supportedFeatures.inheritedQueries == VK_TRUE;
+
+        // The bindless path is optional: it needs descriptor indexing (and maintenance3, which it depends on).
+        std::vector<const char*> enabledExtensions = getRequiredDeviceExtensions();
+        bindlessSupported = isDeviceExtensionSupported(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) && isDeviceExtensionSupported(VK_KHR_MAINTENANCE3_EXTENSION_NAME)
+                         && BindlessDescriptorSet::querySupport(physicalDevice, descriptorIndexingFeatures);
+        if (bindlessSupported)
+        {
+            enabledExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+            enabledExtensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+        }
+
+        // Optional too: the real heap budgets for the memory telemetry (estimated from the heap sizes without it).
+        memoryBudgetSupported = isDeviceExtensionSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        if (memoryBudgetSupported)
+        {
+            enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
 
         VkDeviceCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -579,9 +1015,10 @@ private:
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
         createInfo.pEnabledFeatures = &enabledFeatures;
+        createInfo.pNext = bindlessSupported ? &descriptorIndexingFeatures : nullptr; // Descriptor indexing features of the bindless set.
 
-        createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());;
-        createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+        createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+        createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
         // Enable validation layers if requested
         if (enableValidationLayers) 
@@ -603,6 +1040,38 @@ private:
         // Retrieve the handles for the graphics and present queues
         vkGetDeviceQueue(device, indices.graphicsFamily.value(), 0, &graphicsQueue);
         vkGetDeviceQueue(device, indices.presentFamily.value(), 0, &presentQueue);
+        vkGetDeviceQueue(device, indices.transferFamily.value(), 0, &transferQueue);
+    }
+
+    // Creates the allocator that sub-allocates buffer memory from large per-memory-type blocks.
+    void createMemoryAllocator()
+    {
+        PROFILE_FUNCTION();
+        memoryAllocator.init(physicalDevice, device); // Query the memory types and heaps of the selected GPU.
+        memoryTelemetry.init(physicalDevice, memoryBudgetSupported);
+        memoryAllocator.setTelemetry(&memoryTelemetry); // Every allocation from here on is accounted by heap, type and tag.
+    }
+
+    // Creates the upload manager that copies buffer data on the transfer queue without stalling the render loop.
+    void createUploadManager()
+    {
+        PROFILE_FUNCTION();
+        const QueueFamilyIndices& indices = queueFamilies;
+        uploadManager.init(device, &memoryAllocator, indices.transferFamily.value(), transferQueue, 8ull * 1024 * 1024); // 8 MB staging ring, reused as the upload batches finish.
+    }
+
+    // Creates the pipeline cache from the blob saved by a previous run (if it matches this GPU and driver).
+    void createPipelineCache()
+    {
+        PROFILE_FUNCTION();
+        pipelineCache.init(physicalDevice, device, PIPELINE_CACHE_FILE);
+    }
+
+    // Maps the optional external shader pack. Without it the shaders embedded in the executable are used.
+    void loadShaderPack()
+    {
+        PROFILE_FUNCTION();
+        shaderPack.open(SHADER_PACK_FILE);
     }
 
     // Finds the queue families supported by a given physical device.
@@ -624,36 +1093,57 @@ private:
         for (const auto& queueFamily : queueFamilies)
         {
             // Check if the queue family supports graphics operations.
-            if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+            if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) && !indices.graphicsFamily.has_value())
             {
                 indices.graphicsFamily = i; // Store the index if it supports graphics.
             }
 
             // Check if the queue family supports presenting images to a surface.
+            // Headless mode never presents, so the graphics family stands in for the present family.
             VkBool32 presentSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+            if (options.headless)
+            {
+                presentSupport = indices.graphicsFamily == static_cast<uint32_t>(i);
+            }
+            else
+            {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+            }
 
             // If the queue family supports presenting, store its index.
-            if (presentSupport) 
+            if (presentSupport && !indices.presentFamily.has_value()) 
             {
                 indices.presentFamily = i; // Store the index
             }
 
-            // If all required queue families have been found, stop searching.
-            if (indices.isComplete())
+            // A family with transfer but without graphics or compute is usually backed by the DMA engines.
+            if ((queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queueFamily.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) && !indices.transferFamily.has_value())
             {
-                break;
+                indices.transferFamily = i; // Store the index of the dedicated transfer family.
             }
 
             i++; // Increment the index.
         }
 
+        // Without a dedicated transfer family the uploads go through the graphics queue.
+        if (!indices.transferFamily.has_value())
+        {
+            indices.transferFamily = indices.graphicsFamily;
+        }
+
         return indices; // Return the found queue family indices.
     }
 
     // Creates the swap chain for rendering images to the surface.
     void createSwapChain() 
     {
+        PROFILE_FUNCTION();
+        if (options.headless)
+        {
+            createOffscreenImages(); // Same members, filled with images the application owns.
+            return;
+        }
+
         // Query the swap chain support details for the selected physical device.
         SwapChainSupportDetails swapChainSupport = querySwapChainSupport(physicalDevice);
         
@@ -681,8 +1171,8 @@ private:
         createInfo.imageArrayLayers = 1;                                    // Set the number of layers in the swap chain images (1 for 2D images).
         createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;        // Set the usage of the swap chain images (color attachment for rendering).
 
-        // Find the queue families for graphics and present operations.
-        QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
+        // Queue families for graphics and present operations (found when the device was created).
+        const QueueFamilyIndices& indices = queueFamilies;
 
         uint32_t queueFamilyIndices[] = { indices.graphicsFamily.value(), indices.presentFamily.value() }; // Create an array of queue family indices.
         
@@ -704,6 +1194,8 @@ private:
         createInfo.preTransform = swapChainSupport.capabilities.currentTransform;   // Use the current transform of the surface capabilities.
         createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;              // Opaque composite alpha mode.
         createInfo.presentMode = presentMode;                                       // Set the present mode for the swap chain.
+        activePresentModeName = presentMode == VK_PRESENT_MODE_IMMEDIATE_KHR ? "immediate" : presentMode == VK_PRESENT_MODE_MAILBOX_KHR ? "mailbox"
+                              : presentMode == VK_PRESENT_MODE_FIFO_RELAXED_KHR ? "fifo-relaxed" : "fifo";
         createInfo.clipped = VK_TRUE;                                               // Enable clipping of images that are not visible.
         createInfo.oldSwapchain = VK_NULL_HANDLE;                                   // No previous swap chain, as this is the first one.
 
@@ -721,6 +1213,45 @@ private:
         swapChainExtent = extent;
     }
 
+    // Headless mode: creates one offscreen color image per frame in flight in place of the swap chain images.
+    // Frame slot i always renders into image i, so its fence alone protects the image and no acquire is needed.
+    // The images end the render pass in TRANSFER_SRC_OPTIMAL, ready for the readback copy.
+    void createOffscreenImages()
+    {
+        swapChainImageFormat = HEADLESS_COLOR_FORMAT;
+        swapChainExtent = {options.width, options.height};
+        swapChainImages.resize(MAX_FRAMES_IN_FLIGHT);
+        offscreenImageAllocations.resize(MAX_FRAMES_IN_FLIGHT);
+
+        for (size_t i = 0; i < swapChainImages.size(); i++)
+        {
+            VkImageCreateInfo imageInfo{};
+            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.extent.width = swapChainExtent.width;
+            imageInfo.extent.height = swapChainExtent.height;
+            imageInfo.extent.depth = 1;
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = 1;
+            imageInfo.format = swapChainImageFormat;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT; // Rendered to, then copied out.
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+            if (vkCreateImage(device, &imageInfo, nullptr, &swapChainImages[i]) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create offscreen image!");
+            }
+
+            VkMemoryRequirements memoryRequirements;
+            vkGetImageMemoryRequirements(device, swapChainImages[i], &memoryRequirements);
+            offscreenImageAllocations[i] = memoryAllocator.allocate(memoryRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryTag::Image, false);
+            vkBindImageMemory(device, swapChainImages[i], offscreenImageAllocations[i].memory, offscreenImageAllocations[i].offset);
+        }
+    }
+
     // Queries the swap chain support details for a given physical device.
     SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device) 
     {
@@ -773,6 +1304,21 @@ private:
     // Chooses the best present mode from the available present modes.
     VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes)
     {
+        // A mode requested on the command line wins if the surface supports it.
+        if (options.presentMode != PresentModeOption::Default)
+        {
+            VkPresentModeKHR requested = options.presentMode == PresentModeOption::Immediate ? VK_PRESENT_MODE_IMMEDIATE_KHR
+                                       : options.presentMode == PresentModeOption::Mailbox ? VK_PRESENT_MODE_MAILBOX_KHR
+                                       : options.presentMode == PresentModeOption::FifoRelaxed ? VK_PRESENT_MODE_FIFO_RELAXED_KHR
+                                       : VK_PRESENT_MODE_FIFO_KHR;
+            if (std::find(availablePresentModes.begin(), availablePresentModes.end(), requested) != availablePresentModes.end())
+            {
+                return requested;
+            }
+            std::cerr << "Present mode " << getPresentModeName(options.presentMode) << " is not supported, using fifo" << std::endl;
+            return VK_PRESENT_MODE_FIFO_KHR; // Always supported; a benchmark should not silently switch to mailbox.
+        }
+
         // Iterate through the available present modes to find the best one.
         for (const auto& availablePresentMode : availablePresentModes) 
         {
@@ -816,6 +1362,7 @@ private:
     // Creates image views for the swap chain images.
     void createImageViews() 
     {
+        PROFILE_FUNCTION();
         // Resize the swapChainImageViews vector to match the number of swap chain images.
         swapChainImageViews.resize(swapChainImages.size());
         for (size_t i = 0; i < swapChainImages.size(); i++) 
@@ -843,8 +1390,12 @@ private:
     }
 
     // Creates the render pass for the application.
+    // Subpass 0 is the depth pre-pass: it only writes the depth attachment, and stays empty while the pre-pass is off.
+    // Subpass 1 shades the scene, testing against the depth laid down by subpass 0 (or writing it itself without a
+    // pre-pass). Keeping both subpasses in every configuration lets Z toggle the pre-pass without a new render pass.
     void createRenderPass()
     {
+        PROFILE_FUNCTION();
         VkAttachmentDescription colorAttachment{}; // Create a description for the color attachment used in the render pass.
         colorAttachment.format = swapChainImageFormat; // Set the format of the color attachment to the swap chain image format.
         colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT; // Use 1 sample per pixel (no multisampling).
@@ -853,36 +1404,72 @@ private:
         colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE; // No stencil operations at the start.
         colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE; // No stencil operations.
         colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED; // The initial layout of the attachment is undefined.
-        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; // The final layout is the presentation layout for the swap chain.
+        colorAttachment.finalLayout = options.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL // Offscreen images are only ever copied out.
+                                                       : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; // The final layout is the presentation layout for the swap chain.
+
+        VkAttachmentDescription depthAttachment{}; // Description of the depth attachment.
+        depthAttachment.format = depthFormat; // Format chosen by findDepthFormat.
+        depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT; // Must match the color attachment.
+        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR; // Cleared to the far plane at the start.
+        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE; // Not read after the render pass, so tilers never write it back.
+        depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE; // Stencil is unused.
+        depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED; // The previous contents are discarded.
+        depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
         VkAttachmentReference colorAttachmentRef{}; // Create a reference to the color attachment.
         colorAttachmentRef.attachment = 0; // The index of the color attachment in the render pass.
         colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL; // The layout of the attachment during rendering.
-        
-        VkSubpassDescription subpass{}; // Create a description for the subpass in the render pass.
-        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS; // The subpass is for graphics pipelines.
-        subpass.colorAttachmentCount = 1; // There is one color attachment in this sub
-        subpass.pColorAttachments = &colorAttachmentRef; // Set the color attachment reference for the subpass.
-
-        // Subpass dependency to ensure layout transitions happen correctly.
-        VkSubpassDependency dependency{};
-        dependency.srcSubpass = VK_SUBPASS_EXTERNAL; // Refers to the implicit subpass before or after the render pass.
-        dependency.dstSubpass = 0;                   // Refers to our subpass (index 0).
-        // Operations that must happen before our subpass.
-        dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.srcAccessMask = 0;
-        // Operations that will wait on the source.
-        dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+        VkAttachmentReference depthAttachmentRef{}; // Reference to the depth attachment, shared by both subpasses.
+        depthAttachmentRef.attachment = 1; // The index of the depth attachment in the render pass.
+        depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        std::array<VkSubpassDescription, 2> subpasses{}; // Depth pre-pass, then the color subpass.
+        subpasses[0].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS; // The subpass is for graphics pipelines.
+        subpasses[0].colorAttachmentCount = 0; // Depth only.
+        subpasses[0].pDepthStencilAttachment = &depthAttachmentRef;
+        subpasses[1].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpasses[1].colorAttachmentCount = 1; // There is one color attachment in this subpass.
+        subpasses[1].pColorAttachments = &colorAttachmentRef; // Set the color attachment reference for the subpass.
+        subpasses[1].pDepthStencilAttachment = &depthAttachmentRef;
+
+        // Subpass dependencies to ensure layout transitions happen correctly.
+        std::array<VkSubpassDependency, 3> dependencies{};
+        // The depth buffer is shared by the frames in flight: the pre-pass waits for the depth tests of the previous frame.
+        dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[0].dstSubpass = 0;
+        dependencies[0].srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        // The color subpass waits for the swap chain image (the acquire semaphore waits at the color output stage).
+        dependencies[1].srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[1].dstSubpass = 1;
+        dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependencies[1].srcAccessMask = 0;
+        dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependencies[1].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        // The color subpass tests against the depth written by the pre-pass. Each pixel only needs its own depth,
+        // so tilers keep the depth on chip between the subpasses.
+        dependencies[2].srcSubpass = 0;
+        dependencies[2].dstSubpass = 1;
+        dependencies[2].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependencies[2].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependencies[2].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependencies[2].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependencies[2].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+        std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
 
         VkRenderPassCreateInfo renderPassInfo{}; // Create a structure to hold the render pass creation information.
         renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO; // Specifies the type
-        renderPassInfo.attachmentCount = 1; // There is one attachment in the render pass.
-        renderPassInfo.pAttachments = &colorAttachment; // Set the color attachment description.
-        renderPassInfo.subpassCount = 1; // There is one subpass in the render pass.
-        renderPassInfo.pSubpasses = &subpass; // Set the subpass description.
-        renderPassInfo.dependencyCount = 1; // Number of subpass dependencies.
-        renderPassInfo.pDependencies = &dependency; // Pointer to the subpass dependencies.
+        renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size()); // Color and depth.
+        renderPassInfo.pAttachments = attachments.data(); // Set the attachment descriptions.
+        renderPassInfo.subpassCount = static_cast<uint32_t>(subpasses.size()); // Depth pre-pass and color subpass.
+        renderPassInfo.pSubpasses = subpasses.data(); // Set the subpass descriptions.
+        renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size()); // Number of subpass dependencies.
+        renderPassInfo.pDependencies = dependencies.data(); // Pointer to the subpass dependencies.
 
         if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS) 
         {
@@ -890,12 +1477,89 @@ private:
         }
     }
 
+    // Returns the first candidate format whose optimal tiling supports the requested features.
+    VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkFormatFeatureFlags features)
+    {
+        for (VkFormat format : candidates)
+        {
+            VkFormatProperties properties;
+            vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+            if ((properties.optimalTilingFeatures & features) == features)
+            {
+                return format;
+            }
+        }
+        throw std::runtime_error("failed to find supported format!");
+    }
+
+    // Picks the depth attachment format: 32-bit float depth when available, otherwise a packed depth/stencil format.
+    VkFormat findDepthFormat()
+    {
+        return findSupportedFormat({VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT},
+                                   VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+    }
+
+    // Creates the depth buffer at the swap chain extent. One image serves every frame in flight: the render pass
+    // clears it and never stores it, and its external dependency orders the frames that share it.
+    void createDepthResources()
+    {
+        PROFILE_FUNCTION();
+        depthFormat = findDepthFormat();
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = swapChainExtent.width;
+        imageInfo.extent.height = swapChainExtent.height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = depthFormat;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateImage(device, &imageInfo, nullptr, &depthImage) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create depth image!");
+        }
+
+        // Optimal tiling: the allocator keeps it away from linear resources within bufferImageGranularity.
+        VkMemoryRequirements memoryRequirements;
+        vkGetImageMemoryRequirements(device, depthImage, &memoryRequirements);
+        depthImageAllocation = memoryAllocator.allocate(memoryRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryTag::Image, false);
+        vkBindImageMemory(device, depthImage, depthImageAllocation.memory, depthImageAllocation.offset);
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = depthImage;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = depthFormat;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        if (depthFormat != VK_FORMAT_D32_SFLOAT)
+        {
+            viewInfo.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT; // A depth/stencil attachment view covers both aspects.
+        }
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(device, &viewInfo, nullptr, &depthImageView) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create depth image view!");
+        }
+    }
+
     // Creates the descriptor set layout for the application.
     void createDescriptorSetLayout()
     {
+        PROFILE_FUNCTION();
         VkDescriptorSetLayoutBinding uboLayoutBinding{}; // Create a binding for the uniform buffer object (UBO).
         uboLayoutBinding.binding = 0; // Binding index for the UBO.
-        uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; // Type of descriptor (UBO).
+        uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC; // Type of descriptor (UBO addressed with a dynamic offset).
         uboLayoutBinding.descriptorCount = 1; // Number of descriptors in this binding.
         uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT; // Shader stages that will use this binding (vertex shader).
         uboLayoutBinding.pImmutableSamplers = nullptr; // No immutable samplers used.
@@ -911,103 +1575,64 @@ private:
         }
     }
 
-    // Creates the graphics pipeline for rendering.
-    void createGraphicsPipeline()
+    // Creates the bindless resource set. It replaces the per-draw descriptor binds of the draw list with one bind
+    // per command buffer; resources are registered into it as they are created.
+    void createBindlessDescriptorSet()
     {
-        // Read the SPIR-V shader code from files.
-        auto vertShaderCode = readFile("../shaders/1_triangle/vert.spv");
-        auto fragShaderCode = readFile("../shaders/1_triangle/frag.spv");
-
-        // Create shader modules for the vertex and fragment shaders.
-        VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
-        VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
-
-        // Create shader stage create info structures for the vertex shader.
-        VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
-        vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-        vertShaderStageInfo.module = vertShaderModule;
-        vertShaderStageInfo.pName = "main";
-
-        // Create shader stage create info structure for the fragment shader.
-        VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-        fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-        fragShaderStageInfo.module = fragShaderModule;
-        fragShaderStageInfo.pName = "main";
-
-        // Combine the vertex and fragment shader stage create info into an array.
-        VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
-
-        auto bindingDescription = Vertex::getBindingDescription(); // Get the binding description for vertex input.
-        auto attributeDescriptions = Vertex::getAttributeDescriptions(); // Get the attribute descriptions for vertex input
-
-        // Create the vertex input state create info structure.
-        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputInfo.vertexBindingDescriptionCount = 1;
-        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
-
-        // Create the input assembly state create info structure.
-        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-        inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-        // Create the viewport state create info structure.
-        VkPipelineViewportStateCreateInfo viewportState{};
-        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-        viewportState.viewportCount = 1;
-        viewportState.scissorCount = 1;
-
-        // Create the rasterization state create info structure.
-        VkPipelineRasterizationStateCreateInfo rasterizer{};
-        rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-        rasterizer.depthClampEnable = VK_FALSE;
-        rasterizer.rasterizerDiscardEnable = VK_FALSE;
-        rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-        rasterizer.lineWidth = 1.0f;
-        rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-        rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-        rasterizer.depthBiasEnable = VK_FALSE;
-
-        // Create the multisampling state create info structure.
-        VkPipelineMultisampleStateCreateInfo multisampling{};
-        multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-        multisampling.sampleShadingEnable = VK_FALSE;
-        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-        // Create the color blend state create info structure.
-        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-        colorBlendAttachment.blendEnable = VK_FALSE;
-
-        // Create the color blending state create info structure.
-        VkPipelineColorBlendStateCreateInfo colorBlending{};
-        colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-        colorBlending.logicOpEnable = VK_FALSE;
-        colorBlending.logicOp = VK_LOGIC_OP_COPY;
-        colorBlending.attachmentCount = 1;
-        colorBlending.pAttachments = &colorBlendAttachment;
-        colorBlending.blendConstants[0] = 0.0f;
-        colorBlending.blendConstants[1] = 0.0f;
-        colorBlending.blendConstants[2] = 0.0f;
-        colorBlending.blendConstants[3] = 0.0f;
-
-        // Define dynamic states that can be changed without recreating the pipeline.
-        std::vector<VkDynamicState> dynamicStates = 
-        {
-            VK_DYNAMIC_STATE_VIEWPORT,
-            VK_DYNAMIC_STATE_SCISSOR
-        };
+        PROFILE_FUNCTION();
+        if (bindlessSupported)
+        {
+            bindlessSet.init(physicalDevice, device, BINDLESS_MAX_BUFFERS, BINDLESS_MAX_TEXTURES);
+            if (bindlessSet.getBufferCapacity() < BINDLESS_MAX_BUFFERS || bindlessSet.getTextureCapacity() < BINDLESS_MAX_TEXTURES)
+            {
+                std::cerr << "Bindless arrays clamped to the device limits: " << bindlessSet.getBufferCapacity()
+                          << " buffers, " << bindlessSet.getTextureCapacity() << " textures" << std::endl;
+            }
+        }
+    }
+
+    // Creates the pipeline layout of the bindless variants: the bindless set and the push constants of bindless.vert.
+    void createBindlessPipelineLayout()
+    {
+        VkDescriptorSetLayout setLayout = bindlessSet.getLayout();
+
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(BindlessPushConstants);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &setLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &bindlessPipelineLayout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create bindless pipeline layout!");
+        }
+    }
+
+    // Starts the threads that compile pipeline variants. Half the hardware threads is plenty, since the driver
+    // compiler is mostly busy while the application is still loading.
+    void createPipelineThreads()
+    {
+        PROFILE_FUNCTION();
+        size_t hardwareThreads = std::thread::hardware_concurrency();
+        pipelineThreads.init(hardwareThreads > 1 ? hardwareThreads / 2 : 1);
+    }
 
-        // Create the dynamic state create info structure.
-        VkPipelineDynamicStateCreateInfo dynamicState{};
-        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-        dynamicState.pDynamicStates = dynamicStates.data();
+    // Creates the pipeline layout, queues every pipeline variant and waits only for the default one.
+    // The other variants keep compiling on pipelineThreads while the first frames render.
+    void createGraphicsPipeline()
+    {
+        PROFILE_FUNCTION();
+        // Create shader modules for the vertex and fragment shaders straight from the embedded (or mapped) SPIR-V.
+        // They are shared by every variant, so they live until the builder is cleaned up.
+        vertShaderModule = createShaderModule("1_triangle/shader.vert.spv", SPIRV_1_TRIANGLE_SHADER_VERT, SPIRV_1_TRIANGLE_SHADER_VERT_SIZE);
+        instancedVertShaderModule = createShaderModule("1_triangle/instanced.vert.spv", SPIRV_1_TRIANGLE_INSTANCED_VERT, SPIRV_1_TRIANGLE_INSTANCED_VERT_SIZE);
+        fragShaderModule = createShaderModule("1_triangle/shader.frag.spv", SPIRV_1_TRIANGLE_SHADER_FRAG, SPIRV_1_TRIANGLE_SHADER_FRAG_SIZE);
 
         // Create the pipeline layout create info structure.
         VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
@@ -1022,66 +1647,207 @@ private:
             throw std::runtime_error("failed to create pipeline layout!");
         }
 
-        // Create the graphics pipeline create info structure.
-        VkGraphicsPipelineCreateInfo pipelineInfo{};
-        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineInfo.stageCount = 2;
-        pipelineInfo.pStages = shaderStages;
-        pipelineInfo.pVertexInputState = &vertexInputInfo;
-        pipelineInfo.pInputAssemblyState = &inputAssembly;
-        pipelineInfo.pViewportState = &viewportState;
-        pipelineInfo.pRasterizationState = &rasterizer;
-        pipelineInfo.pMultisampleState = &multisampling;
-        pipelineInfo.pColorBlendState = &colorBlending;
-        pipelineInfo.pDynamicState = &dynamicState;
-        pipelineInfo.layout = pipelineLayout;
-        pipelineInfo.renderPass = renderPass;
-        pipelineInfo.subpass = 0;
-        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-
-        // Create the graphics pipeline.
-        if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create graphics pipeline!");
-        }
-
-        // Destroy the shader modules after the pipeline is created, as they are no longer needed.
-        vkDestroyShaderModule(device, fragShaderModule, nullptr);
-        vkDestroyShaderModule(device, vertShaderModule, nullptr);
+        PipelineBase base;
+        base.vertexShader = vertShaderModule;
+        base.fragmentShader = fragShaderModule;
+        base.layout = pipelineLayout;
+        base.renderPass = renderPass;
+        pipelineBuilder.init(device, pipelineCache.getHandle(), &pipelineThreads, base);
+
+        base.vertexShader = instancedVertShaderModule;
+        instancedPipelineBuilder.init(device, pipelineCache.getHandle(), &pipelineThreads, base);
+
+        // Per-object path: binding 0 only.
+        VertexLayout vertexLayout;
+        vertexLayout.bindings = {Vertex::getBindingDescription(vertexFormat)};
+        vertexLayout.attributes = Vertex::getAttributeDescriptions(vertexFormat);
+
+        // Instanced path: binding 0 per vertex and binding 1 per instance.
+        VertexLayout instancedLayout;
+        auto instancedBindings = Vertex::getInstancedBindingDescriptions(vertexFormat);
+        instancedLayout.bindings.assign(instancedBindings.begin(), instancedBindings.end());
+        instancedLayout.attributes = Vertex::getInstancedAttributeDescriptions(vertexFormat);
+
+        // Every path shares the queuing below; the bindless one only exists with descriptor indexing.
+        struct PathSetup
+        {
+            PipelineBuilder* builder;
+            const VertexLayout* vertexLayout;
+            PathPipelines* pipelines;
+        };
+        std::vector<PathSetup> paths = {{&pipelineBuilder, &vertexLayout, &drawListPipelines}, {&instancedPipelineBuilder, &instancedLayout, &instancedPipelines}};
+        if (bindlessSupported)
+        {
+            // Same vertex inputs as the draw list; the matrices come from the bindless set.
+            bindlessVertShaderModule = createShaderModule("1_triangle/bindless.vert.spv", SPIRV_1_TRIANGLE_BINDLESS_VERT, SPIRV_1_TRIANGLE_BINDLESS_VERT_SIZE);
+            createBindlessPipelineLayout();
+            base.vertexShader = bindlessVertShaderModule;
+            base.layout = bindlessPipelineLayout;
+            bindlessPipelineBuilder.init(device, pipelineCache.getHandle(), &pipelineThreads, base);
+            paths.push_back({&bindlessPipelineBuilder, &vertexLayout, &bindlessPipelines});
+        }
+
+        // Queue every variant, then block only on the default one, timing it to compare cold and warm starts.
+        // The selectable variants of every path are queued first, so the workers pick them up before the depth
+        // pre-pass pipelines.
+        auto pipelineStart = std::chrono::high_resolution_clock::now();
+        for (PathSetup& path : paths)
+        {
+            path.pipelines->variants = path.builder->buildAll(createPipelineVariants(*path.vertexLayout, false));
+        }
+        for (PathSetup& path : paths)
+        {
+            path.pipelines->depthOnly = path.builder->build(createDepthOnlyVariant(*path.vertexLayout));
+            path.pipelines->prePassVariants = path.builder->buildAll(createPipelineVariants(*path.vertexLayout, true));
+        }
+        size_t pipelineCount = 0;
+        for (PathSetup& path : paths)
+        {
+            pipelineCount += path.builder->getPipelineCount();
+        }
+        graphicsPipeline = drawListPipelines.variants[0].get();
+        activePipelineVariant = 0;
+        requestedPipelineVariant = 0;
+        double pipelineMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - pipelineStart).count();
+        std::cout << "Graphics pipeline created in " << pipelineMilliseconds << " ms (" << (pipelineCache.isWarm() ? "warm" : "cold") << " cache), "
+                  << pipelineCount - 1 << " more variant(s) compiling on " << pipelineThreads.getThreadCount() << " thread(s)" << std::endl;
+    }
+
+    // Returns the pipeline variants selectable with the V key for a vertex layout, and fills pipelineVariantNames.
+    // Every variant draws in the color subpass. After the depth pre-pass the depth buffer already holds the nearest
+    // surface, so the variants only test against it; without it the opaque ones write it themselves.
+    std::vector<PipelinePermutation> createPipelineVariants(const VertexLayout& vertexLayout, bool afterDepthPrePass)
+    {
+        PipelinePermutation opaque;
+        opaque.vertexLayout = vertexLayout;
+        opaque.specialization.set(2, positionScale); // POSITION_SCALE, shared by every variant
+        opaque.depthMode = afterDepthPrePass ? DepthMode::TestOnly : DepthMode::TestAndWrite;
+        opaque.subpass = 1;
+
+        std::vector<PipelinePermutation> permutations;
+        permutations.push_back(opaque);
+        pipelineVariantNames = {"opaque"};
+
+        PipelinePermutation noCull = opaque;
+        noCull.cullMode = VK_CULL_MODE_NONE;
+        permutations.push_back(noCull);
+        pipelineVariantNames.push_back("no culling");
+
+        PipelinePermutation translucent = opaque;
+        translucent.blendMode = BlendMode::Alpha;
+        translucent.cullMode = VK_CULL_MODE_NONE;
+        translucent.depthMode = DepthMode::TestOnly; // Blended geometry does not hide what is behind it.
+        translucent.specialization.set(1, 0.5f); // ALPHA
+        permutations.push_back(translucent);
+        pipelineVariantNames.push_back("alpha blended");
+
+        PipelinePermutation additive = opaque;
+        additive.blendMode = BlendMode::Additive;
+        additive.cullMode = VK_CULL_MODE_NONE;
+        additive.depthMode = DepthMode::TestOnly;
+        additive.specialization.set(0, 0.35f); // COLOR_SCALE
+        permutations.push_back(additive);
+        pipelineVariantNames.push_back("additive");
+
+        if (wireframeSupported)
+        {
+            PipelinePermutation wireframe = opaque;
+            wireframe.polygonMode = VK_POLYGON_MODE_LINE;
+            wireframe.cullMode = VK_CULL_MODE_NONE;
+            permutations.push_back(wireframe);
+            pipelineVariantNames.push_back("wireframe");
+        }
+
+        return permutations;
+    }
+
+    // Returns the depth pre-pass pipeline for a vertex layout: the opaque variant with no fragment shader, in subpass 0.
+    PipelinePermutation createDepthOnlyVariant(const VertexLayout& vertexLayout)
+    {
+        PipelinePermutation depthOnly;
+        depthOnly.vertexLayout = vertexLayout;
+        depthOnly.specialization.set(2, positionScale); // Same POSITION_SCALE, so the depth matches the color subpass
+        depthOnly.depthMode = DepthMode::DepthOnly;
+        depthOnly.subpass = 0;
+        return depthOnly;
     }
 
-    // Reads a file and returns its contents as a vector of characters.
-    static std::vector<char> readFile(const std::string& filename) 
+    // Returns the pipelines a render path draws with. The GPU-driven path draws the compacted instances with the
+    // instanced vertex layout.
+    PathPipelines& getPathPipelines(RenderPath path)
     {
-        // Open the file in binary mode and move the read pointer to the end to get the file size.
-        std::ifstream file(filename, std::ios::ate | std::ios::binary);
+        switch (path)
+        {
+        case RenderPath::DrawList:
+            return drawListPipelines;
+        case RenderPath::Bindless:
+            return bindlessPipelines;
+        default:
+            return instancedPipelines;
+        }
+    }
 
-        // Check if the file was opened successfully.
-        if (!file.is_open()) {
-            throw std::runtime_error("failed to open file!");
+    // Switches to the variant selected with the V key, the path selected with the I / G / B keys and the depth pre-pass
+    // selected with the Z key once the corresponding pipelines are ready. Never blocks the render loop.
+    void applyPipelineVariant()
+    {
+        bool depthPrePass = depthPrePassPipeline != VK_NULL_HANDLE;
+        if (requestedPipelineVariant == activePipelineVariant && requestedRenderPath == renderPath && requestedDepthPrePass == depthPrePass)
+        {
+            return;
         }
 
-        // Get the size of the file and create a buffer to hold its contents.
-        size_t fileSize = (size_t) file.tellg();
-        std::vector<char> buffer(fileSize);
+        PathPipelines& pipelines = getPathPipelines(requestedRenderPath);
+        std::shared_future<VkPipeline>& variant = requestedDepthPrePass ? pipelines.prePassVariants[requestedPipelineVariant] : pipelines.variants[requestedPipelineVariant];
+        std::shared_future<VkPipeline>& depthOnly = pipelines.depthOnly;
+        if (variant.wait_for(std::chrono::seconds(0)) != std::future_status::ready ||
+            (requestedDepthPrePass && depthOnly.wait_for(std::chrono::seconds(0)) != std::future_status::ready))
+        {
+            return; // Still compiling: keep drawing with the current pipelines.
+        }
 
-        // Move the read pointer back to the beginning of the file and read its contents into the buffer.
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
+        try
+        {
+            VkPipeline colorPipeline = variant.get();
+            VkPipeline prePassPipeline = requestedDepthPrePass ? depthOnly.get() : VK_NULL_HANDLE;
+            graphicsPipeline = colorPipeline;
+            depthPrePassPipeline = prePassPipeline;
+            activePipelineVariant = requestedPipelineVariant;
+            renderPath = requestedRenderPath;
+            invalidateCommandBuffers(); // The pipelines are baked into the cached command buffers.
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Pipeline variant " << pipelineVariantNames[requestedPipelineVariant] << " failed: " << e.what() << std::endl;
+            requestedPipelineVariant = activePipelineVariant;
+            requestedRenderPath = renderPath;
+            requestedDepthPrePass = depthPrePass;
+        }
+    }
 
-        // Close the file after reading its contents.
-        file.close();
+    // Creates a shader module, preferring the shader pack entry called packName over the embedded SPIR-V.
+    // Both sources are already 4-byte aligned words, so the code is passed to the driver without any copy.
+    VkShaderModule createShaderModule(const char* packName, const uint32_t* embeddedCode, size_t embeddedSize)
+    {
+        const uint32_t* code = embeddedCode;
+        size_t codeSize = embeddedSize;
+        if (shaderPack.isOpen() && !shaderPack.find(packName, code, codeSize))
+        {
+            code = embeddedCode; // Not in the pack: fall back to the embedded copy.
+            codeSize = embeddedSize;
+        }
 
-        return buffer; // Return the buffer containing the file contents.
+        return createShaderModule(code, codeSize);
     }
 
-    // Creates a shader module from the provided SPIR-V code.
-    VkShaderModule createShaderModule(const std::vector<char>& code) 
+    // Creates a shader module from the provided SPIR-V code (size in bytes).
+    VkShaderModule createShaderModule(const uint32_t* code, size_t codeSize)
     {
         // Create a VkShaderModuleCreateInfo structure to hold the shader module creation parameters.
         VkShaderModuleCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = code.size();
-        createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+        createInfo.codeSize = codeSize;
+        createInfo.pCode = code;
 
         // Attempt to create the shader module using the Vulkan API.
         VkShaderModule shaderModule;
@@ -1096,19 +1862,20 @@ private:
     // Creates framebuffers for each swap chain image view.
     void createFramebuffers()
     {
+        PROFILE_FUNCTION();
         // Resize the framebuffers vector to match the number of swap chain image views.
         swapChainFramebuffers.resize(swapChainImageViews.size());
 
         // Iterate through each swap chain image view to create a framebuffer.
         for (size_t i = 0; i < swapChainImageViews.size(); i++) 
         {
-            VkImageView attachments[] = { swapChainImageViews[i] }; // Attach the current image view to the framebuffer.
+            VkImageView attachments[] = { swapChainImageViews[i], depthImageView }; // The swap chain image and the shared depth buffer.
 
             // Create the framebuffer create info structure.
             VkFramebufferCreateInfo framebufferInfo{};
             framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
             framebufferInfo.renderPass = renderPass; // The render pass to use with this framebuffer.
-            framebufferInfo.attachmentCount = 1; // Number of attachments in the framebuffer.
+            framebufferInfo.attachmentCount = 2; // Number of attachments in the framebuffer.
             framebufferInfo.pAttachments = attachments; // The array of attachments.
             framebufferInfo.width = swapChainExtent.width; // Width of the framebuffer.
             framebufferInfo.height = swapChainExtent.height; // Height of the framebuffer.
@@ -1122,78 +1889,98 @@ private:
         }
     }
 
-    // Creates a command pool for managing command buffers.
-    void createCommandPool()
+    // Maps MESH_FILE if it exists and uses the Vertex layout; otherwise the built-in quad is used.
+    void loadMesh()
     {
-        QueueFamilyIndices queueFamilyIndices = findQueueFamilies(physicalDevice); // Find the queue families for the physical device.
-
-        // Create a command pool create info structure.
-        VkCommandPoolCreateInfo poolInfo{};
-        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT; // Allow command buffers to be reset individually.
-        poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value(); // Use the graphics queue family index.
-
-        // Attempt to create the command pool using the Vulkan API.
-        if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS) 
+        PROFILE_FUNCTION();
+        if (meshFile.open(MESH_FILE))
         {
-            throw std::runtime_error("failed to create command pool!");
+            const MeshFileHeader& header = meshFile.getHeader();
+            if (header.vertexFormat != MESH_VERTEX_FORMAT_POS2_COLOR3 || header.vertexStride != sizeof(Vertex))
+            {
+                std::cerr << "Mesh file: " << MESH_FILE << " does not use the Vertex layout, using the built-in quad" << std::endl;
+                meshFile.close();
+            }
+            else if (!(header.flags & MESH_FLAG_OPTIMIZED))
+            {
+                std::cerr << "Mesh file: " << MESH_FILE << " was not cooked, drawing it in authored order (run cook_mesh on it)" << std::endl;
+            }
         }
+
+        indexCount = meshFile.isOpen() ? meshFile.getHeader().indexCount : static_cast<uint32_t>(indices.size());
+        indexType = meshFile.isOpen() ? meshFile.getIndexType() : VK_INDEX_TYPE_UINT16;
     }
 
-    // Creates a vertex buffer for the triangle. 
-    void createVertexBuffer()
+    // Returns the Vertex array to upload: the mesh file's vertices (read in place) or the built-in quad.
+    VertexStreams getVertexStreams() const
     {
-        VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size(); // Calculate the size of the vertex buffer.
-
-        // Create a staging buffer to transfer vertex data to the GPU.
-        VkBuffer stagingBuffer; // Create a buffer to hold the vertex data temporarily.
-        VkDeviceMemory stagingBufferMemory; // Create a memory object to hold the buffer data.
-
-        // Create the staging buffer with the specified size, usage, and memory properties.
-        createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory); // Create the staging buffer.
+        const Vertex* source = meshFile.isOpen() ? static_cast<const Vertex*>(meshFile.getVertexData()) : vertices.data();
+        VertexStreams streams;
+        streams.count = meshFile.isOpen() ? meshFile.getHeader().vertexCount : vertices.size();
+        streams.positions = source->pos;
+        streams.positionStride = sizeof(Vertex);
+        streams.colors = source->color;
+        streams.colorStride = sizeof(Vertex);
+        return streams;
+    }
 
-        // Copy the vertex data to the buffer.
-        void* data; // Create a pointer to hold the mapped memory address.
-        vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data); // Map the buffer memory to the pointer.
-        memcpy(data, vertices.data(), bufferSize); // Copy the vertex data to the mapped memory.
-        vkUnmapMemory(device, stagingBufferMemory); // Unmap the memory after copying.
+    // Selects the compact vertex layout if the device can fetch its formats, and the position scale it needs.
+    void chooseVertexFormat()
+    {
+        PROFILE_FUNCTION();
+        VertexFormat compact;
+        compact.position = VERTEX_POSITION_ENCODING;
+        compact.color = VERTEX_COLOR_ENCODING;
+        if (compact.isSupported(physicalDevice))
+        {
+            vertexFormat = compact;
+        }
+        else
+        {
+            std::cerr << "Vertex format " << compact.getName() << " is not supported, using float32" << std::endl;
+        }
 
-        // Create the vertex buffer to hold the vertex data on the GPU.
-        createBuffer(bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer, vertexBufferMemory); // Create the vertex buffer.
-    
-        // Copy the data from the staging buffer to the vertex buffer.
-        copyBuffer(stagingBuffer, vertexBuffer, bufferSize); // Copy the vertex data from the staging buffer to the vertex buffer.
-        vkDestroyBuffer(device, stagingBuffer, nullptr); // Destroy the staging buffer as it is no longer needed.
-        vkFreeMemory(device, stagingBufferMemory, nullptr); // Free the memory allocated for the staging buffer.
+        positionScale = vertexFormat.position == PositionEncoding::Snorm16 ? computePositionScale(getVertexStreams()) : 1.0f;
+        std::cout << "Vertex format: " << vertexFormat.getName() << ", " << vertexFormat.getStride() << " bytes per vertex (" << sizeof(Vertex) << " unpacked)" << std::endl;
     }
 
-    // Finds a suitable memory type based on the type filter and properties.
-    uint32_t findMemoryTypeIndex(uint32_t typeFilter, VkMemoryPropertyFlags properties) 
+    // Creates a vertex buffer for the triangle. 
+    void createVertexBuffer()
     {
-        VkPhysicalDeviceMemoryProperties memProperties; // Create a memory properties structure.
-        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties); // Get the memory properties of the physical device.
+        PROFILE_FUNCTION();
+        VertexStreams streams = getVertexStreams();
+        VkDeviceSize bufferSize = streams.count * vertexFormat.getStride(); // Calculate the size of the vertex buffer.
 
-        // Iterate through the memory types to find a suitable one.
-        for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) 
-        {
-            // Check if the memory type is suitable based on the type filter and properties.
-            if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) 
-            {
-                return i; // Return the index of the suitable memory type.
-            }
-        }
+        // Create the vertex buffer to hold the vertex data on the GPU.
+        createBuffer(bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryTag::Vertex, vertexBuffer, vertexBufferAllocation); // Create the vertex buffer.
 
-        throw std::runtime_error("failed to find suitable memory type!"); // Throw an error if no suitable memory type is found.
+        // Record the copy into the open upload batch, then pack the vertices into the chosen layout straight from the
+        // mesh mapping into the staging memory it reads (no intermediate copy, nothing waits here).
+        void* stagingVertices = uploadManager.reserveBufferUpload(vertexBuffer, 0, bufferSize);
+        packVertices(vertexFormat, streams, positionScale, stagingVertices);
     }
 
     // Creates a buffer with the specified size, usage, and memory properties.
-    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& vertexBuffer, VkDeviceMemory& vertexBufferMemory)
+    // The memory comes from the sub-allocator, so no vkAllocateMemory call is made per buffer; tag is what the memory
+    // telemetry accounts it under.
+    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, MemoryTag tag, VkBuffer& vertexBuffer, MemoryAllocation& allocation)
     {
         VkBufferCreateInfo bufferInfo{}; // Create a buffer create info structure.
         bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO; // Specify the type of the structure.
         bufferInfo.size = size; // Specify the size of the buffer in bytes.
         bufferInfo.usage = usage; // Specify the buffer usage.
         bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // Specify the sharing mode.
+
+        // Upload targets written on a separate transfer family are shared with the graphics family,
+        // so no queue family ownership transfer is needed before drawing from them.
+        const QueueFamilyIndices& indices = queueFamilies;
+        uint32_t queueFamilyIndices[] = { indices.graphicsFamily.value(), indices.transferFamily.value() };
+        if ((usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT) && indices.graphicsFamily != indices.transferFamily)
+        {
+            bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            bufferInfo.queueFamilyIndexCount = 2;
+            bufferInfo.pQueueFamilyIndices = queueFamilyIndices;
+        }
     
         if (vkCreateBuffer(device, &bufferInfo, nullptr, &vertexBuffer) != VK_SUCCESS) 
         {
@@ -1202,115 +1989,59 @@ private:
 
         VkMemoryRequirements memRequirements; // Create a memory requirements structure.
         vkGetBufferMemoryRequirements(device, vertexBuffer, &memRequirements); // Get the memory requirements for the buffer.
-        VkMemoryAllocateInfo allocInfo{}; // Create a memory allocate info structure.
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO; // Specify the type of the structure.
-        allocInfo.allocationSize = memRequirements.size; // Set the allocation size to the buffer's memory requirements size.
-        allocInfo.memoryTypeIndex = findMemoryTypeIndex(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT); // Find a suitable memory type index.
 
-        if (vkAllocateMemory(device, &allocInfo, nullptr, &vertexBufferMemory) != VK_SUCCESS) 
-        {
-            throw std::runtime_error("failed to allocate vertex buffer memory!"); // Throw an error if memory allocation fails.
-        }
+        // Sub-allocate memory with the requested property flags (device local, host visible, ...).
+        allocation = memoryAllocator.allocate(memRequirements, properties, tag);
 
-        vkBindBufferMemory(device, vertexBuffer, vertexBufferMemory, 0); // Bind the allocated memory to the buffer.
+        vkBindBufferMemory(device, vertexBuffer, allocation.memory, allocation.offset); // Bind the allocated memory range to the buffer.
     }
 
-    // Begins recording a single-use command buffer.
-    void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
+    // Destroys a buffer and returns its memory to the allocator.
+    void destroyBuffer(VkBuffer& buffer, MemoryAllocation& allocation)
     {
-        VkCommandBufferAllocateInfo allocInfo{}; // Create a command buffer allocate info structure.
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO; // Specify the type of the structure.
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY; // Specify the command buffer level (primary in this case).
-        allocInfo.commandPool = commandPool; // Specify the command pool to allocate from.
-        allocInfo.commandBufferCount = 1; // Allocate a single command buffer.
-
-        VkCommandBuffer commandBuffer; // Create a command buffer variable.
-        vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer); // Allocate the command buffer.
-
-        VkCommandBufferBeginInfo beginInfo{}; // Create a command buffer begin info structure.
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO; // Specify the type of the structure.
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT; // Specify that the command buffer will be submitted only once.
-
-        vkBeginCommandBuffer(commandBuffer, &beginInfo); // Begin recording commands into the command buffer.
-
-        VkBufferCopy copyRegion{}; // Create a buffer copy region structure.
-        copyRegion.srcOffset = 0; // Set the source offset to 0 (start of the source buffer).
-        copyRegion.dstOffset = 0; // Set the destination offset to 0 (start of the destination buffer).
-        copyRegion.size = size; // Set the size of data to copy.
-
-        vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion); // Record the buffer copy command into the command buffer.
-
-        vkEndCommandBuffer(commandBuffer); // End recording commands into the command buffer.
-
-        VkSubmitInfo submitInfo{}; // Create a submit info structure.
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO; // Specify the type of the structure.
-        submitInfo.commandBufferCount = 1; // Specify that we are submitting a single command buffer.
-        submitInfo.pCommandBuffers = &commandBuffer; // Set the pointer to the command buffer to submit.
-
-        vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE); // Submit the command buffer to the graphics queue.
-        vkQueueWaitIdle(graphicsQueue); // Wait for the graphics queue to become idle (all submitted commands have finished executing).
-
-        vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer); // Free the command buffer after use.
+        vkDestroyBuffer(device, buffer, nullptr); // Destroy the buffer.
+        memoryAllocator.free(allocation); // Give the memory range back to its block.
+        buffer = VK_NULL_HANDLE;
     }
 
     // Creates command buffers for recording rendering commands.
     void createIndexBuffer()
     {
-        VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size(); // Calculate the size of the index buffer.
-
-        // Create a staging buffer to transfer index data to the GPU.
-        VkBuffer stagingBuffer; // Create a buffer to hold the index data temporarily.
-        VkDeviceMemory stagingBufferMemory; // Create a memory object to hold the buffer data.
-
-        // Create the staging buffer with the specified size, usage, and memory properties.
-        createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory); // Create the staging buffer.
-
-        // Copy the index data to the buffer.
-        void* data; // Create a pointer to hold the mapped memory address.
-        vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data); // Map the buffer memory to the pointer.
-        memcpy(data, indices.data(), bufferSize); // Copy the index data to the mapped memory.
-        vkUnmapMemory(device, stagingBufferMemory); // Unmap the memory after copying.
+        PROFILE_FUNCTION();
+        // 16- or 32-bit indices from the mesh file (already in cooked order), staged straight from the mapping.
+        const void* indexData = meshFile.isOpen() ? meshFile.getIndexData() : indices.data();
+        VkDeviceSize bufferSize = meshFile.isOpen() ? meshFile.getHeader().indexBytes : sizeof(indices[0]) * indices.size(); // Calculate the size of the index buffer.
 
         // Create the index buffer to hold the index data on the GPU.
-        createBuffer(bufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuffer, indexBufferMemory); // Create the index buffer.
+        createBuffer(bufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryTag::Index, indexBuffer, indexBufferAllocation); // Create the index buffer.
     
-        // Copy the data from the staging buffer to the index buffer.
-        copyBuffer(stagingBuffer, indexBuffer, bufferSize); // Copy the index data from the staging buffer to the index buffer.
-        vkDestroyBuffer(device, stagingBuffer, nullptr); // Destroy the staging buffer as it is no longer needed.
-        vkFreeMemory(device, stagingBufferMemory, nullptr); // Free the memory allocated for the staging buffer.
+        // Stage the index data and record the copy into the open upload batch (nothing waits here).
+        uploadManager.enqueueBufferUpload(indexBuffer, 0, indexData, bufferSize);
     }
 
-    // Creates uniform buffers for each swap chain image.
+    // Creates the uniform arena shared by every object of every frame in flight.
     void createUniformBuffers()
     {
-        VkDeviceSize bufferSize = sizeof(UniformBufferObject); // Calculate the size of the uniform buffer.
-
-        // Resize the uniformBuffers and uniformBuffersMemory vectors to match the number of swap chain images.
-        uniformBuffers.resize(swapChainImages.size());
-        uniformBuffersMemory.resize(swapChainImages.size());
-        uniformBuffersMapped.resize(swapChainImages.size());
-
-        // Create a uniform buffer for each swap chain image.
-        for (size_t i = 0; i < swapChainImages.size(); i++) 
-        {
-            createBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, uniformBuffers[i], uniformBuffersMemory[i]); // Create the uniform buffer.
-
-            vkMapMemory(device, uniformBuffersMemory[i], 0, bufferSize, 0, &uniformBuffersMapped[i]); // Map the buffer memory to the pointer.
-        }
+        PROFILE_FUNCTION();
+        // One region of MAX_UNIFORM_OBJECTS entries per frame in flight, each entry aligned to minUniformBufferOffsetAlignment.
+        uniformRing.init(physicalDevice, device, &memoryAllocator, sizeof(UniformBufferObject), MAX_UNIFORM_OBJECTS, MAX_FRAMES_IN_FLIGHT);
     }
 
     // Creates a descriptor pool for allocating descriptor sets.
     void createDescriptorPool()
     {
-        VkDescriptorPoolSize poolSize{}; // Create a descriptor pool size structure.
-        poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; // Specify the type of descriptor (uniform buffer).
-        poolSize.descriptorCount = static_cast<uint32_t>(swapChainImages.size()); // Set the number of descriptors in the pool.
+        PROFILE_FUNCTION();
+        std::array<VkDescriptorPoolSize, 2> poolSizes{}; // Create the descriptor pool size structures.
+        poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC; // Specify the type of descriptor (dynamic uniform buffer).
+        poolSizes[0].descriptorCount = 1 + MAX_FRAMES_IN_FLIGHT; // The graphics set plus one culling set per frame slot.
+        poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER; // Object table, visible instances and indirect command.
+        poolSizes[1].descriptorCount = 3 * MAX_FRAMES_IN_FLIGHT;
 
         VkDescriptorPoolCreateInfo poolInfo{}; // Create a descriptor pool create info structure.
         poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO; // Specify the type of the structure.
-        poolInfo.poolSizeCount = 1; // Number of different descriptor types in the pool.
-        poolInfo.pPoolSizes = &poolSize; // Pointer to the array of pool sizes.
-        poolInfo.maxSets = static_cast<uint32_t>(swapChainImages.size()); // Maximum number of descriptor sets that can be allocated from the pool.
+        poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size()); // Number of different descriptor types in the pool.
+        poolInfo.pPoolSizes = poolSizes.data(); // Pointer to the array of pool sizes.
+        poolInfo.maxSets = 1 + MAX_FRAMES_IN_FLIGHT; // Maximum number of descriptor sets that can be allocated from the pool.
 
         if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS) 
         {
@@ -1318,90 +2049,576 @@ private:
         }
     }
 
-    // Creates descriptor sets for each swap chain image.
+    // Creates the descriptor set that points at the uniform arena.
     void createDescriptorSets()
     {
-        std::vector<VkDescriptorSetLayout> layouts(swapChainImages.size(), descriptorSetLayout); // Create a vector of descriptor set layouts.
+        PROFILE_FUNCTION();
         VkDescriptorSetAllocateInfo allocInfo{}; // Create a descriptor set allocate info structure.
         allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO; // Specify the type of the structure.
         allocInfo.descriptorPool = descriptorPool; // Specify the descriptor pool to allocate from.
-        allocInfo.descriptorSetCount = static_cast<uint32_t>(swapChainImages.size()); // Number of descriptor sets to allocate.
-        allocInfo.pSetLayouts = layouts.data(); // Pointer to the array of descriptor set layouts. 
-        descriptorSets.resize(swapChainImages.size()); // Resize the descriptorSets vector to match the number of swap chain images.
+        allocInfo.descriptorSetCount = 1; // Number of descriptor sets to allocate.
+        allocInfo.pSetLayouts = &descriptorSetLayout; // Pointer to the descriptor set layout.
     
-        if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) != VK_SUCCESS) 
+        if (vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet) != VK_SUCCESS) 
         {
             throw std::runtime_error("failed to allocate descriptor sets!"); // Throw an error if descriptor set allocation fails.
         }   
 
-        // Update each descriptor set with the corresponding uniform buffer information.
-        for (size_t i = 0; i < swapChainImages.size(); i++) 
+        // The descriptor covers one entry; the dynamic offset given at bind time selects which one.
+        VkDescriptorBufferInfo bufferInfo{}; // Create a descriptor buffer info structure.
+        bufferInfo.buffer = uniformRing.getBuffer(); // Specify the uniform arena.
+        bufferInfo.offset = 0; // Base offset; the dynamic offset is added to it.
+        bufferInfo.range = uniformRing.getElementSize(); // Size of one UniformBufferObject.
+
+        VkWriteDescriptorSet descriptorWrite{}; // Create a write descriptor set structure.
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; // Specify the type of the
+        descriptorWrite.dstSet = descriptorSet; // Specify the destination descriptor set to update.
+        descriptorWrite.dstBinding = 0; // Specify the binding within the descriptor set to update
+        descriptorWrite.dstArrayElement = 0; // Specify the first array element to update.
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC; // Specify the type of descriptor.
+        descriptorWrite.descriptorCount = 1; // Number of descriptors to update.
+        descriptorWrite.pBufferInfo = &bufferInfo; // Pointer to the buffer info structure.
+        descriptorWrite.pImageInfo = nullptr; // No image info used.
+        descriptorWrite.pTexelBufferView = nullptr; // No texel buffer view used.
+        vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr); // Update the descriptor set with the new information.
+
+        // The bindless path reads the same arena as a storage buffer.
+        if (bindlessSupported)
         {
-            VkDescriptorBufferInfo bufferInfo{}; // Create a descriptor buffer info structure.
-            bufferInfo.buffer = uniformBuffers[i]; // Specify the uniform buffer for this descriptor set.
-            bufferInfo.offset = 0; // Set the offset within the buffer.
-            bufferInfo.range = sizeof(UniformBufferObject); // Set the size of the buffer.  
+            uniformArenaSlot = bindlessSet.addBuffer(uniformRing.getBuffer());
+        }
+    }
+
+    // Creates the compute pipeline of the GPU-driven path and one descriptor set per frame slot.
+    void createCullPipeline()
+    {
+        PROFILE_FUNCTION();
+        std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+        bindings[0].binding = 0; // Uniform arena (camera and animation time).
+        bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        bindings[0].descriptorCount = 1;
+        bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        for (uint32_t i = 1; i < bindings.size(); i++)
+        {
+            bindings[i].binding = i; // 1: object table, 2: visible instances, 3: indirect command.
+            bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+        layoutInfo.pBindings = bindings.data();
+        if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &cullDescriptorSetLayout) != VK_SUCCESS) 
+        {
+            throw std::runtime_error("failed to create culling descriptor set layout!");
+        }
 
-            VkWriteDescriptorSet descriptorWrite{}; // Create a write descriptor set structure.
-            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; // Specify the type of the
-            descriptorWrite.dstSet = descriptorSets[i]; // Specify the destination descriptor set to update.
-            descriptorWrite.dstBinding = 0; // Specify the binding within the descriptor set to update
-            descriptorWrite.dstArrayElement = 0; // Specify the first array element to update.
-            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; // Specify the type of descriptor.
-            descriptorWrite.descriptorCount = 1; // Number of descriptors to update.
-            descriptorWrite.pBufferInfo = &bufferInfo; // Pointer to the buffer info structure.
-            descriptorWrite.pImageInfo = nullptr; // No image info used.
-            descriptorWrite.pTexelBufferView = nullptr; // No texel buffer view used.
-            vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr); // Update the descriptor set with the new information.
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(CullPushConstants);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &cullDescriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &cullPipelineLayout) != VK_SUCCESS) 
+        {
+            throw std::runtime_error("failed to create culling pipeline layout!");
+        }
+
+        VkShaderModule cullShaderModule = createShaderModule("1_triangle/cull.comp.spv", SPIRV_1_TRIANGLE_CULL_COMP, SPIRV_1_TRIANGLE_CULL_COMP_SIZE);
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = cullShaderModule;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.layout = cullPipelineLayout;
+
+        // The graphics family also supports compute (the spec guarantees a graphics queue family with compute).
+        VkResult result = vkCreateComputePipelines(device, pipelineCache.getHandle(), 1, &pipelineInfo, nullptr, &cullPipeline);
+        vkDestroyShaderModule(device, cullShaderModule, nullptr);
+        if (result != VK_SUCCESS) 
+        {
+            throw std::runtime_error("failed to create culling pipeline!");
+        }
+
+        std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> setLayouts;
+        setLayouts.fill(cullDescriptorSetLayout);
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = descriptorPool;
+        allocInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+        allocInfo.pSetLayouts = setLayouts.data();
+        if (vkAllocateDescriptorSets(device, &allocInfo, cullDescriptorSets.data()) != VK_SUCCESS) 
+        {
+            throw std::runtime_error("failed to allocate culling descriptor sets!");
+        }
+
+        for (uint32_t slot = 0; slot < MAX_FRAMES_IN_FLIGHT; slot++)
+        {
+            std::array<VkDescriptorBufferInfo, 4> bufferInfos{};
+            bufferInfos[0] = {uniformRing.getBuffer(), 0, uniformRing.getElementSize()}; // The dynamic offset selects the entry.
+            bufferInfos[1] = {objectTableBuffer, 0, VK_WHOLE_SIZE};
+            bufferInfos[2] = {visibleInstanceBuffers[slot], 0, VK_WHOLE_SIZE};
+            bufferInfos[3] = {drawCommandBuffers[slot], 0, VK_WHOLE_SIZE};
+
+            std::array<VkWriteDescriptorSet, 4> writes{};
+            for (uint32_t i = 0; i < writes.size(); i++)
+            {
+                writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writes[i].dstSet = cullDescriptorSets[slot];
+                writes[i].dstBinding = i;
+                writes[i].descriptorCount = 1;
+                writes[i].descriptorType = bindings[i].descriptorType;
+                writes[i].pBufferInfo = &bufferInfos[i];
+            }
+            vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
         }
     }
 
-    // Creates command buffers for recording rendering commands.
-    void createCommandBuffers()
+    // Creates the resources of every frame in flight.
+    void createFrameContexts()
     {
-        // Resize the command buffers vector to match swapChainImages.size().
-        commandBuffers.resize(swapChainImages.size());
+        PROFILE_FUNCTION();
+        const QueueFamilyIndices& queueFamilyIndices = queueFamilies; // Queue families found when the device was created.
+        frames.resize(framesInFlight);
 
-        // Allocate command buffers from the command pool.
-        VkCommandBufferAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.commandPool = commandPool;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandBufferCount = (uint32_t)commandBuffers.size(); // Allocate enough command buffers.
+        for (uint32_t i = 0; i < framesInFlight; i++)
+        {
+            FrameContext& frame = frames[i];
+
+            // Each frame owns its pool; cached buffers are reset individually when they need re-recording.
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT; // Allow command buffers to be reset individually.
+            poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value(); // Use the graphics queue family index.
+
+            if (vkCreateCommandPool(device, &poolInfo, nullptr, &frame.commandPool) != VK_SUCCESS) 
+            {
+                throw std::runtime_error("failed to create command pool!");
+            }
+
+            // Semaphore creation info.
+            VkSemaphoreCreateInfo semaphoreInfo{};
+            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+            // Fence creation info, initialized as signaled to allow the first frame to proceed.
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // Create in a signaled state.
+
+            if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &frame.imageAvailableSemaphore) != VK_SUCCESS ||
+                vkCreateFence(device, &fenceInfo, nullptr, &frame.inFlightFence) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create synchronization objects for a frame!");
+            }
+
+            frame.uniformRegion = i; // Frame slot i writes region i of the uniform ring.
 
-        if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) != VK_SUCCESS) 
+            // One pool per recording slice: a pool may only be used by one thread at a time.
+            frame.workerCommandPools.resize(recordingThreads.getThreadCount());
+            for (auto& workerPool : frame.workerCommandPools)
+            {
+                if (vkCreateCommandPool(device, &poolInfo, nullptr, &workerPool) != VK_SUCCESS) 
+                {
+                    throw std::runtime_error("failed to create command pool!");
+                }
+            }
+        }
+
+        allocateCachedCommandBuffers();
+
+        currentFrame = 0;
+    }
+
+    // Makes sure every frame has one cached command buffer per swap chain image.
+    void allocateCachedCommandBuffers()
+    {
+        for (auto& frame : frames)
         {
-            throw std::runtime_error("failed to allocate command buffers!");
+            size_t oldCount = frame.commandBuffers.size();
+            if (oldCount >= swapChainImages.size())
+            {
+                continue; // Extra buffers from a larger swap chain are simply left unused.
+            }
+
+            frame.commandBuffers.resize(swapChainImages.size());
+            frame.recordedGenerations.resize(swapChainImages.size(), 0);
+            frame.recordedUniformOffsets.resize(swapChainImages.size(), 0);
+            frame.secondaryCommandBuffers.resize(swapChainImages.size());
+
+            // Allocate the primary command buffers that are missing.
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = frame.commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = static_cast<uint32_t>(swapChainImages.size() - oldCount);
+
+            if (vkAllocateCommandBuffers(device, &allocInfo, &frame.commandBuffers[oldCount]) != VK_SUCCESS) 
+            {
+                throw std::runtime_error("failed to allocate command buffers!");
+            }
+
+            // Allocate the secondary command buffers of the new images, each from the pool of its slice.
+            for (size_t image = oldCount; image < swapChainImages.size(); image++)
+            {
+                frame.secondaryCommandBuffers[image].resize(frame.workerCommandPools.size());
+                for (size_t worker = 0; worker < frame.workerCommandPools.size(); worker++)
+                {
+                    VkCommandBufferAllocateInfo secondaryAllocInfo{};
+                    secondaryAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                    secondaryAllocInfo.commandPool = frame.workerCommandPools[worker];
+                    secondaryAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+                    secondaryAllocInfo.commandBufferCount = 1;
+
+                    if (vkAllocateCommandBuffers(device, &secondaryAllocInfo, &frame.secondaryCommandBuffers[image][worker]) != VK_SUCCESS) 
+                    {
+                        throw std::runtime_error("failed to allocate command buffers!");
+                    }
+                }
+            }
         }
     }
 
-    // Creates synchronization objects (semaphores and fences) for frame management.
-    void createSyncObjects() 
+    // Marks every cached command buffer as stale. Call whenever the render pass, framebuffers, pipeline,
+    // bound buffers or draw parameters change; the buffers are re-recorded lazily when next used.
+    void invalidateCommandBuffers()
+    {
+        commandBufferGeneration++;
+    }
+
+    // Creates one render finished semaphore per swap chain image.
+    void createPresentSemaphores()
     {
-        // Resize vectors to hold synchronization objects for each frame in flight.
-        imageAvailableSemaphores.resize(swapChainImages.size());
+        PROFILE_FUNCTION();
+        if (options.headless)
+        {
+            return; // Nothing is presented.
+        }
+
         renderFinishedSemaphores.resize(swapChainImages.size());
-        inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
 
-        // Semaphore creation info.
         VkSemaphoreCreateInfo semaphoreInfo{};
         semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-        // Fence creation info, initialized as signaled to allow the first frame to proceed.
-        VkFenceCreateInfo fenceInfo{};
-        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // Create in a signaled state.
-
-        // Create semaphores and fences for each frame.
         for (size_t i = 0; i < swapChainImages.size(); i++) {
-            if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]) != VK_SUCCESS ||
-                vkCreateSemaphore(device, &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS ||
-                vkCreateFence(device, &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS) {
+            if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS) {
                 throw std::runtime_error("failed to create synchronization objects for a frame!");
             }
         }
     }
 
+    // Creates one fragment shader invocation counter per frame slot for the overdraw mode (O key). Dividing the
+    // invocations of a frame by its pixel count gives the average number of times each pixel was shaded.
+    void createOverdrawQueryPool()
+    {
+        PROFILE_FUNCTION();
+        if (!overdrawCounterSupported)
+        {
+            return; // The title reports that the counter is unavailable.
+        }
+
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        queryPoolInfo.queryCount = MAX_FRAMES_IN_FLIGHT;
+        queryPoolInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+        if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &overdrawQueryPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create overdraw query pool!");
+        }
+    }
+
+    // Creates the timestamp pools of the GPU pass timer and registers the passes of recordCommandBuffer.
+    // A new compute or transfer pass gets its own addPass and beginPass / endPass pair.
+    void createGpuProfiler()
+    {
+        PROFILE_FUNCTION();
+        const QueueFamilyIndices& indices = queueFamilies;
+        if (!gpuProfiler.init(physicalDevice, device, indices.graphicsFamily.value(), MAX_FRAMES_IN_FLIGHT, GPU_PROFILER_MAX_PASSES))
+        {
+            std::cout << "GPU timestamps are not supported by the graphics queue, pass timing is off" << std::endl;
+        }
+        cullGpuPass = gpuProfiler.addPass("cull");
+        renderGpuPass = gpuProfiler.addPass("render");
+    }
+
+    // Starts the reader thread of the frame statistics and prepares their overlay: a pipeline drawing CPU-built quads
+    // in the color subpass without depth, and a vertex buffer region per frame slot rewritten every frame. The vertex
+    // count never changes, so the cached command buffers stay valid while the histograms move.
+    void createFrameStats()
+    {
+        PROFILE_FUNCTION();
+        frameStats.start();
+
+        overlayVertShaderModule = createShaderModule("1_triangle/overlay.vert.spv", SPIRV_1_TRIANGLE_OVERLAY_VERT, SPIRV_1_TRIANGLE_OVERLAY_VERT_SIZE);
+        PipelineBase base;
+        base.vertexShader = overlayVertShaderModule;
+        base.fragmentShader = fragShaderModule;
+        base.layout = pipelineLayout; // Unused by the overlay shaders; compatible with the scene's bound set.
+        base.renderPass = renderPass;
+        overlayPipelineBuilder.init(device, pipelineCache.getHandle(), &pipelineThreads, base);
+
+        VkVertexInputBindingDescription binding{};
+        binding.binding = 0;
+        binding.stride = sizeof(OverlayVertex);
+        binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        std::vector<VkVertexInputAttributeDescription> attributes(2);
+        attributes[0].location = 0;
+        attributes[0].binding = 0;
+        attributes[0].format = VK_FORMAT_R32G32_SFLOAT;
+        attributes[0].offset = offsetof(OverlayVertex, position);
+        attributes[1].location = 1;
+        attributes[1].binding = 0;
+        attributes[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributes[1].offset = offsetof(OverlayVertex, color);
+
+        PipelinePermutation overlay;
+        overlay.vertexLayout.bindings = {binding};
+        overlay.vertexLayout.attributes = attributes;
+        overlay.blendMode = BlendMode::Alpha;
+        overlay.cullMode = VK_CULL_MODE_NONE;
+        overlay.depthMode = DepthMode::Disabled; // Always on top of the scene.
+        overlay.subpass = 1;
+        overlay.specialization.set(1, 0.8f); // ALPHA
+        overlayPipelineBuild = overlayPipelineBuilder.build(overlay);
+
+        createBuffer(sizeof(OverlayVertex) * OVERLAY_VERTEX_COUNT * MAX_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, MemoryTag::Vertex, overlayVertexBuffer, overlayVertexAllocation);
+    }
+
+    // Reads the fragment count of the last submission of a frame slot. Called after the slot's fence was waited
+    // on, so the result is available and the read never stalls.
+    void readOverdrawQuery(uint32_t slot)
+    {
+        if (!overdrawQueryPending[slot])
+        {
+            return;
+        }
+        overdrawQueryPending[slot] = false;
+
+        uint64_t fragmentInvocations = 0;
+        if (vkGetQueryPoolResults(device, overdrawQueryPool, slot, 1, sizeof(fragmentInvocations), &fragmentInvocations, sizeof(fragmentInvocations), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+        {
+            overdrawAccumulator += static_cast<double>(fragmentInvocations) / (static_cast<double>(swapChainExtent.width) * swapChainExtent.height);
+            overdrawSampleCount++;
+        }
+    }
+
+    // Starts the worker threads used to record the draw list in parallel.
+    void createRecordingThreads()
+    {
+        PROFILE_FUNCTION();
+        // Leave one hardware thread to the main thread, which records the primary buffer meanwhile.
+        size_t hardwareThreads = std::thread::hardware_concurrency();
+        recordingThreads.init(hardwareThreads > 1 ? hardwareThreads - 1 : 1);
+    }
+
+    // Lays the draw list out as a grid of small quads in the XY plane, and registers their bounds for culling.
+    void createSceneObjects()
+    {
+        PROFILE_FUNCTION();
+        const float extent = 3.0f; // Side of the area covered by the grid (fits the camera at (2, 2, 2)).
+        const float spacing = extent / SCENE_GRID_SIZE;
+
+        // Radius of the mesh around its origin: the quads spin, so the bounds must hold every rotation.
+        // The culling pass of the GPU-driven path uses the same radius.
+        VertexStreams streams = getVertexStreams();
+        meshRadius = 0.0f;
+        for (size_t i = 0; i < streams.count; i++)
+        {
+            const float* position = reinterpret_cast<const float*>(reinterpret_cast<const char*>(streams.positions) + i * streams.positionStride);
+            meshRadius = std::max(meshRadius, std::sqrt(position[0] * position[0] + position[1] * position[1]));
+        }
+
+        sceneObjects.clear();
+        sceneCuller.clear();
+        sceneTransforms.clear();
+        sceneRootNode = sceneTransforms.addNode(TRANSFORM_NO_PARENT, glm::value_ptr(glm::mat4(1.0f)));
+        for (uint32_t y = 0; y < SCENE_GRID_SIZE; y++)
+        {
+            for (uint32_t x = 0; x < SCENE_GRID_SIZE; x++)
+            {
+                SceneObject object{};
+                object.position = glm::vec2((x + 0.5f) * spacing - extent * 0.5f, (y + 0.5f) * spacing - extent * 0.5f);
+                object.scale = spacing * 0.8f;
+                object.phase = 0.1f * static_cast<float>(x + y);
+                object.transform = sceneTransforms.addNode(sceneRootNode, glm::value_ptr(glm::mat4(1.0f))); // Placed by the first uniform update.
+                sceneObjects.push_back(object);
+
+                float radius = meshRadius * object.scale;
+                float center[3] = {object.position.x, object.position.y, 0.0f};
+                float boxMin[3] = {center[0] - radius, center[1] - radius, 0.0f};
+                float boxMax[3] = {center[0] + radius, center[1] + radius, 0.0f};
+                sceneCuller.addObject(center, radius, boxMin, boxMax);
+            }
+        }
+    }
+
+    // Lays the instance grid out over the same area as the draw list and creates the host-visible instance buffer.
+    // The buffer holds one region of instances per frame in flight, so the CPU never writes data the GPU is reading.
+    void createInstanceBuffer()
+    {
+        PROFILE_FUNCTION();
+        const float extent = 3.0f; // Same area as the draw list.
+        const float spacing = extent / INSTANCE_GRID_SIZE;
+
+        instances.clear();
+        instances.reserve(INSTANCE_GRID_SIZE * INSTANCE_GRID_SIZE);
+        for (uint32_t y = 0; y < INSTANCE_GRID_SIZE; y++)
+        {
+            for (uint32_t x = 0; x < INSTANCE_GRID_SIZE; x++)
+            {
+                InstanceData instance{};
+                instance.position = glm::vec2((x + 0.5f) * spacing - extent * 0.5f, (y + 0.5f) * spacing - extent * 0.5f);
+                instance.scale = spacing * 0.8f;
+                instance.rotation = 0.01f * static_cast<float>(x + y); // Phase; the animated angle is added per frame.
+                uint32_t red = x * 255 / INSTANCE_GRID_SIZE;
+                uint32_t green = y * 255 / INSTANCE_GRID_SIZE;
+                instance.color = red | (green << 8) | (255u << 16) | (255u << 24); // RGBA8, little endian.
+                instances.push_back(instance);
+            }
+        }
+
+        VkDeviceSize regionSize = sizeof(InstanceData) * instances.size();
+        createBuffer(regionSize * MAX_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, MemoryTag::Vertex, instanceBuffer, instanceBufferAllocation);
+    }
+
+    // Writes the instances of this frame straight into its region of the mapped instance buffer, in one pass.
+    void updateInstanceBuffer(uint32_t region)
+    {
+        PROFILE_FUNCTION();
+        float angle = getAnimationTime() * glm::radians(90.0f);
+
+        InstanceData* destination = static_cast<InstanceData*>(instanceBufferAllocation.mappedData) + static_cast<size_t>(region) * instances.size();
+        for (size_t i = 0; i < instances.size(); i++)
+        {
+            destination[i] = instances[i];
+            destination[i].rotation += angle;
+        }
+    }
+
+    // Picks up the overlay pipeline once it has compiled and writes the histograms of the latest frame statistics
+    // snapshot into this frame's region of the overlay vertex buffer. Each metric gets a row in the top left corner:
+    // a dark background, one bar per FRAME_STATS_BIN_MILLISECONDS bin (scaled to the fullest bin) and a white p99 marker.
+    void updateOverlay(uint32_t region)
+    {
+        if (!frameStatsOverlayEnabled)
+        {
+            return;
+        }
+        if (overlayPipeline == VK_NULL_HANDLE)
+        {
+            if (overlayPipelineBuild.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                return; // Still compiling: the frame is recorded without the overlay.
+            }
+            try
+            {
+                overlayPipeline = overlayPipelineBuild.get();
+                invalidateCommandBuffers(); // Record the overlay draw from now on.
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "Frame statistics overlay pipeline failed: " << e.what() << std::endl;
+                frameStatsOverlayEnabled = false;
+                return;
+            }
+        }
+        frameStats.tryGetSnapshot(frameStatsSnapshot); // Keeps the previous snapshot if the reader is publishing.
+
+        const float left = -0.98f;
+        const float top = -0.98f;
+        const float width = 0.6f;
+        const float rowHeight = 0.12f;
+        const float rowSpacing = 0.02f;
+        const float barWidth = width / FRAME_STATS_BINS;
+        const float metricColors[FRAME_METRIC_COUNT][3] = {
+            {0.3f, 0.6f, 1.0f},  // CPU
+            {0.3f, 1.0f, 0.4f},  // GPU
+            {1.0f, 0.8f, 0.2f},  // Fence wait
+            {1.0f, 0.35f, 0.3f}  // Present latency
+        };
+        const float backgroundColor[3] = {0.08f, 0.08f, 0.08f};
+        const float markerColor[3] = {1.0f, 1.0f, 1.0f};
+
+        OverlayVertex* vertex = static_cast<OverlayVertex*>(overlayVertexAllocation.mappedData) + static_cast<size_t>(region) * OVERLAY_VERTEX_COUNT;
+        auto writeQuad = [&vertex](float x0, float y0, float x1, float y1, const float* color) {
+            const float corners[6][2] = {{x0, y0}, {x1, y0}, {x1, y1}, {x0, y0}, {x1, y1}, {x0, y1}};
+            for (const auto& corner : corners)
+            {
+                *vertex++ = {{corner[0], corner[1]}, {color[0], color[1], color[2]}};
+            }
+        };
+
+        for (uint32_t metric = 0; metric < FRAME_METRIC_COUNT; metric++)
+        {
+            const FrameMetricSummary& summary = frameStatsSnapshot.metrics[metric];
+            float rowTop = top + metric * (rowHeight + rowSpacing);
+            float rowBottom = rowTop + rowHeight;
+            writeQuad(left, rowTop, left + width, rowBottom, backgroundColor);
+
+            uint32_t fullestBin = *std::max_element(summary.bins, summary.bins + FRAME_STATS_BINS);
+            for (uint32_t bin = 0; bin < FRAME_STATS_BINS; bin++)
+            {
+                float barHeight = fullestBin > 0 ? rowHeight * summary.bins[bin] / fullestBin : 0.0f; // Empty bins collapse to a line.
+                float barLeft = left + bin * barWidth;
+                writeQuad(barLeft, rowBottom - barHeight, barLeft + barWidth * 0.8f, rowBottom, metricColors[metric]);
+            }
+
+            float markerX = left + std::min(summary.p99 / FRAME_STATS_BIN_MILLISECONDS, static_cast<float>(FRAME_STATS_BINS)) * barWidth;
+            writeQuad(markerX - 0.002f, rowTop, markerX + 0.002f, rowBottom, markerColor);
+        }
+    }
+
+    // Creates the buffers of the GPU-driven path. The object table is uploaded once with the rest of the geometry;
+    // each frame slot gets its own visible instance buffer and indirect command, written only by the GPU.
+    void createGpuDrivenBuffers()
+    {
+        PROFILE_FUNCTION();
+        VkDeviceSize tableSize = sizeof(InstanceData) * instances.size();
+        createBuffer(tableSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                     MemoryTag::Storage, objectTableBuffer, objectTableAllocation);
+        uploadManager.enqueueBufferUpload(objectTableBuffer, 0, instances.data(), tableSize);
+
+        for (uint32_t slot = 0; slot < MAX_FRAMES_IN_FLIGHT; slot++)
+        {
+            createBuffer(tableSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                         MemoryTag::Storage, visibleInstanceBuffers[slot], visibleInstanceAllocations[slot]);
+            createBuffer(sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryTag::Storage, drawCommandBuffers[slot], drawCommandAllocations[slot]);
+        }
+    }
+
+    // Changes the number of frames in flight, rebuilding the frame contexts.
+    void setFramesInFlight(uint32_t count)
+    {
+        count = std::clamp<uint32_t>(count, 1, MAX_FRAMES_IN_FLIGHT);
+        if (count == framesInFlight)
+        {
+            return;
+        }
+
+        vkDeviceWaitIdle(device); // No frame may be using the contexts that are destroyed.
+        destroyFrameContexts();
+        framesInFlight = count;
+        createFrameContexts();
+
+        std::cout << "Frames in flight: " << framesInFlight << std::endl;
+        submittedFrameStarts = {}; // The wait above was not a frame's fence wait.
+        statsStartTime = getTime(); // Start a new measurement window for the new setting.
+        statsFrameCount = 0;
+    }
+
     # pragma endregion
 
     // Main function to run the application.
@@ -1409,68 +2626,393 @@ private:
     // The main application loop where events are polled and frames are drawn.
     void mainLoop()
     {
-        // Loop as long as the window should not close (e.g., user clicks the close button).
-        while (!glfwWindowShouldClose(window))
+        statsStartTime = getTime(); // Start the first frame-time measurement window.
+        lastPipelineCacheSave = statsStartTime;
+
+        // Loop as long as the window should not close (e.g., user clicks the close button) and the frame count is not reached.
+        while (!shouldExit())
         {
-            glfwPollEvents(); // Process all pending GLFW events (e.g., keyboard input, mouse movement).
+            double frameStart = getTime();
+            uint32_t submittedFrames = renderedFrameCount;
+            if (!options.headless)
+            {
+                glfwPollEvents(); // Process all pending GLFW events (e.g., keyboard input, mouse movement).
+            }
+
+            // Apply a new frames-in-flight setting between frames.
+            if (requestedFramesInFlight != 0)
+            {
+                setFramesInFlight(requestedFramesInFlight);
+                requestedFramesInFlight = 0;
+            }
+
+            applyPipelineVariant(); // Switch pipelines once the selected variant has compiled.
+            if (cullBenchmarkEnabled)
+            {
+                runCullBenchmark(); // Measure the CPU culling of the benchmark set with the current camera.
+            }
             drawFrame();      // Draw a single frame.
+            updateFrameStats(); // Show the average frame time for the current setting in the window title.
+            if (renderedFrameCount != submittedFrames)
+            {
+                double frameSeconds = getTime() - frameStart;
+                benchmark.recordFrame(frameSeconds); // Frames skipped for a swap chain recreation are not measured.
+                recordFrameStats(frameSeconds);
+            }
+
+            // Persist pipelines compiled since the last save, so a crash does not lose them.
+            if (getTime() - lastPipelineCacheSave > PIPELINE_CACHE_SAVE_INTERVAL)
+            {
+                pipelineCache.save();
+                lastPipelineCacheSave = getTime();
+            }
         }
 
         // Wait for the device to finish all pending operations before exiting.
         vkDeviceWaitIdle(device);
+
+        if (options.headless && !options.readbackFile.empty())
+        {
+            writeReadbackImage(options.readbackFile); // The last frame is complete after the wait.
+        }
+    }
+
+    // True once the window was closed or the warmup and measured frames were rendered.
+    bool shouldExit()
+    {
+        if (options.frameCount > 0 && renderedFrameCount >= options.warmupFrames + options.frameCount)
+        {
+            return true;
+        }
+        return !options.headless && glfwWindowShouldClose(window);
+    }
+
+    // Queues the sample of a finished loop iteration for the frame statistics reader. Never blocks.
+    void recordFrameStats(double frameSeconds)
+    {
+        FrameStatsSample sample;
+        sample.milliseconds[static_cast<uint32_t>(FrameMetric::Cpu)] = static_cast<float>(frameSeconds * 1000.0 - lastFenceWaitMilliseconds);
+        sample.milliseconds[static_cast<uint32_t>(FrameMetric::Gpu)] = static_cast<float>(gpuProfiler.getLastFrameMilliseconds()); // Collected a few frames late.
+        sample.milliseconds[static_cast<uint32_t>(FrameMetric::FenceWait)] = static_cast<float>(lastFenceWaitMilliseconds);
+        sample.milliseconds[static_cast<uint32_t>(FrameMetric::PresentLatency)] = static_cast<float>(lastFrameLatencyMilliseconds);
+        frameStats.push(sample);
+    }
+
+    // Seconds since an arbitrary start point. Used instead of glfwGetTime, which needs GLFW to be initialized.
+    static double getTime()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Copies the image of the last frame into a host-visible buffer and writes it as a binary PPM (RGB, 8 bits per channel).
+    // Called after vkDeviceWaitIdle: the image is in TRANSFER_SRC_OPTIMAL, the final layout of the headless render pass.
+    void writeReadbackImage(const std::string& path)
+    {
+        VkDeviceSize imageSize = static_cast<VkDeviceSize>(swapChainExtent.width) * swapChainExtent.height * 4; // HEADLESS_COLOR_FORMAT is 4 bytes per pixel.
+        VkBuffer readbackBuffer;
+        MemoryAllocation readbackAllocation;
+        createBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, MemoryTag::Staging, readbackBuffer, readbackAllocation);
+
+        // A one-time command buffer from the first frame's pool, which is idle after the wait.
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = frames[0].commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate readback command buffer!");
+        }
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0; // Tightly packed rows.
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = {swapChainExtent.width, swapChainExtent.height, 1};
+        vkCmdCopyImageToBuffer(commandBuffer, swapChainImages[lastImageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackBuffer, 1, &region);
+
+        // Make the copy visible to the host reads below.
+        VkMemoryBarrier hostBarrier{};
+        hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to record readback command buffer!");
+        }
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+        if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to submit readback command buffer!");
+        }
+        vkQueueWaitIdle(graphicsQueue);
+        vkFreeCommandBuffers(device, frames[0].commandPool, 1, &commandBuffer);
+
+        // Drop the alpha channel: PPM stores RGB triplets.
+        const uint8_t* pixels = static_cast<const uint8_t*>(readbackAllocation.mappedData);
+        std::vector<uint8_t> rgb(static_cast<size_t>(swapChainExtent.width) * swapChainExtent.height * 3);
+        for (size_t pixel = 0; pixel < rgb.size() / 3; pixel++)
+        {
+            rgb[pixel * 3 + 0] = pixels[pixel * 4 + 0];
+            rgb[pixel * 3 + 1] = pixels[pixel * 4 + 1];
+            rgb[pixel * 3 + 2] = pixels[pixel * 4 + 2];
+        }
+        destroyBuffer(readbackBuffer, readbackAllocation);
+
+        std::ofstream file(path, std::ios::binary);
+        file << "P6\n" << swapChainExtent.width << " " << swapChainExtent.height << "\n255\n";
+        file.write(reinterpret_cast<const char*>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+        if (!file)
+        {
+            throw std::runtime_error("failed to write readback image!");
+        }
+        std::cout << "Wrote frame " << renderedFrameCount << " to " << path << std::endl;
+    }
+
+    // Shows the frames in flight and the average frame time of the last second in the window title.
+    void updateFrameStats()
+    {
+        statsFrameCount++;
+        double now = getTime();
+        double elapsed = now - statsStartTime;
+        if (elapsed < 1.0)
+        {
+            return;
+        }
+
+        std::string title = std::string(APP_NAME) + " - " + std::to_string(framesInFlight) + " frame(s) in flight - "
+                          + std::to_string(elapsed * 1000.0 / statsFrameCount) + " ms/frame - "
+                          + (renderPath == RenderPath::DrawList ? std::to_string(visibleObjectCount) + "/" + std::to_string(sceneObjects.size()) + " draws"
+                             : renderPath == RenderPath::Bindless ? "1 bindless draw (" + std::to_string(visibleObjectCount) + "/" + std::to_string(sceneObjects.size()) + " objects)"
+                             : renderPath == RenderPath::Instanced ? "1 instanced draw (" + std::to_string(instances.size()) + " quads)"
+                             : "1 GPU-driven indirect draw (" + std::to_string(instances.size()) + " objects)") + " - "
+                          + std::to_string(reusedFrameCount) + " reused / " + std::to_string(recordedFrameCount) + " recorded - "
+                          + (parallelRecording ? "parallel" : "inline") + " recording "
+                          + std::to_string(recordTimeCount > 0 ? recordTimeAccumulator * 1000.0 / recordTimeCount : 0.0) + " ms - "
+                          + pipelineVariantNames[activePipelineVariant] + (depthPrePassPipeline != VK_NULL_HANDLE ? " + depth pre-pass" : "")
+                          + (requestedPipelineVariant != activePipelineVariant || requestedRenderPath != renderPath
+                             || requestedDepthPrePass != (depthPrePassPipeline != VK_NULL_HANDLE) ? " (compiling)" : "");
+        if (overdrawCounterEnabled)
+        {
+            title += !overdrawCounterSupported ? std::string(" - overdraw counter not supported")
+                   : " - overdraw " + std::to_string(overdrawSampleCount > 0 ? overdrawAccumulator / overdrawSampleCount : 0.0) + " fragments/pixel";
+        }
+        for (uint32_t pass = 0; pass < gpuProfiler.getPassCount(); pass++)
+        {
+            if (gpuProfiler.getSampleCount(pass) > 0)
+            {
+                title += " - GPU " + gpuProfiler.getPassName(pass) + " " + std::to_string(gpuProfiler.getAverageMilliseconds(pass)) + " ms";
+            }
+        }
+        if (frameStatsOverlayEnabled && frameStats.tryGetSnapshot(frameStatsSnapshot))
+        {
+            // p50 / p99 over the last FRAME_STATS_WINDOW frames, next to the histograms of the overlay.
+            for (uint32_t metric = 0; metric < FRAME_METRIC_COUNT; metric++)
+            {
+                const FrameMetricSummary& summary = frameStatsSnapshot.metrics[metric];
+                title += std::string(metric == 0 ? " - p50/p99 " : ", ") + FrameStatsCollector::getMetricName(static_cast<FrameMetric>(metric)) + " "
+                       + std::to_string(summary.p50) + "/" + std::to_string(summary.p99) + " ms";
+            }
+            if (frameStatsSnapshot.droppedSamples > 0)
+            {
+                title += " (" + std::to_string(frameStatsSnapshot.droppedSamples) + " samples dropped)";
+            }
+        }
+        if (cullTimeCount > 0)
+        {
+            title += " - " + std::string(FrustumCuller::getInstructionSetName()) + " cull of " + std::to_string(benchmarkCuller.getObjectCount()) + " objects: spheres "
+                   + std::to_string(sphereCullTimeAccumulator * 1000.0 / cullTimeCount) + " ms, boxes " + std::to_string(boxCullTimeAccumulator * 1000.0 / cullTimeCount)
+                   + " ms (" + std::to_string(benchmarkVisibleCount) + " visible)";
+        }
+        if (options.headless)
+        {
+            std::cout << title << std::endl; // No window title to show it in.
+        }
+        else
+        {
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        memoryTelemetry.checkBudget(std::cerr); // Once per window: one vkGetPhysicalDeviceMemoryProperties2 call.
+
+        statsStartTime = now;
+        statsFrameCount = 0;
+        recordTimeAccumulator = 0.0;
+        recordTimeCount = 0;
+        sphereCullTimeAccumulator = 0.0;
+        boxCullTimeAccumulator = 0.0;
+        cullTimeCount = 0;
+        overdrawAccumulator = 0.0;
+        overdrawSampleCount = 0;
+    }
+
+    // Culls CULL_BENCHMARK_OBJECTS random objects against the camera, once as spheres and once as boxes, and
+    // accumulates the times for the window title. The objects are only created the first time.
+    void runCullBenchmark()
+    {
+        PROFILE_FUNCTION();
+        if (benchmarkCuller.getObjectCount() == 0)
+        {
+            std::mt19937 random(74);
+            std::uniform_real_distribution<float> position(-5.0f, 5.0f);
+            std::uniform_real_distribution<float> size(0.01f, 0.1f);
+            for (uint32_t i = 0; i < CULL_BENCHMARK_OBJECTS; i++)
+            {
+                float center[3] = {position(random), position(random), position(random)};
+                float radius = size(random);
+                float boxMin[3] = {center[0] - radius, center[1] - radius, center[2] - radius};
+                float boxMax[3] = {center[0] + radius, center[1] + radius, center[2] + radius};
+                benchmarkCuller.addObject(center, radius, boxMin, boxMax);
+            }
+        }
+
+        auto sphereStart = std::chrono::high_resolution_clock::now();
+        benchmarkVisibleCount = benchmarkCuller.cull(glm::value_ptr(cameraViewProjection), BoundsShape::Sphere, benchmarkVisible);
+        auto boxStart = std::chrono::high_resolution_clock::now();
+        benchmarkCuller.cull(glm::value_ptr(cameraViewProjection), BoundsShape::Box, benchmarkVisible);
+        auto boxEnd = std::chrono::high_resolution_clock::now();
+
+        sphereCullTimeAccumulator += std::chrono::duration<double>(boxStart - sphereStart).count();
+        boxCullTimeAccumulator += std::chrono::duration<double>(boxEnd - boxStart).count();
+        cullTimeCount++;
     }
 
     // Draws a single frame of the application.
     void drawFrame() 
     {
+        PROFILE_FUNCTION();
+        FrameContext& frame = frames[currentFrame];
+        double frameStart = getTime();
+
         // Wait for the fence of the current frame to be signaled (previous frame finished).
-        vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+        {
+            PROFILE_ZONE("vkWaitForFences");
+            vkWaitForFences(device, 1, &frame.inFlightFence, VK_TRUE, UINT64_MAX);
+        }
 
-        uint32_t imageIndex;
-        // Acquire an image from the swap chain. The imageAvailableSemaphore will be signaled when an image is ready.
-        VkResult result = vkAcquireNextImageKHR(device, swapChain, UINT64_MAX, imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+        // The latency of the slot's previous frame ends here: the earliest point the CPU learns that it finished.
+        double fenceSignaled = getTime();
+        double& previousStart = submittedFrameStarts[frame.uniformRegion];
+        lastFenceWaitMilliseconds = (fenceSignaled - frameStart) * 1000.0;
+        lastFrameLatencyMilliseconds = previousStart > 0.0 ? (fenceSignaled - previousStart) * 1000.0 : 0.0;
+        previousStart = 0.0;
+        readOverdrawQuery(frame.uniformRegion); // The query of the finished submission is ready.
+        gpuProfiler.collect(frame.uniformRegion); // So are its timestamps.
+
+        // Headless mode: each frame slot renders into its own offscreen image, which its fence already protects.
+        uint32_t imageIndex = currentFrame;
+        VkResult result = VK_SUCCESS;
+        if (!options.headless)
+        {
+            // Acquire an image from the swap chain. The imageAvailableSemaphore will be signaled when an image is ready.
+            {
+                PROFILE_ZONE("vkAcquireNextImageKHR");
+                result = vkAcquireNextImageKHR(device, swapChain, UINT64_MAX, frame.imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+            }
 
-        // Handle swap chain being out-of-date or suboptimal (e.g., window resized).
-        if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-            recreateSwapChain(); // Recreate the swap chain.
-            return;
-        } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-            throw std::runtime_error("failed to acquire swap chain image!");
+            // Handle swap chain being out-of-date or suboptimal (e.g., window resized).
+            if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+                recreateSwapChain(); // Recreate the swap chain.
+                return;
+            } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+                throw std::runtime_error("failed to acquire swap chain image!");
+            }
         }
 
         // Reset the fence for the current frame before submitting new commands.
-        vkResetFences(device, 1, &inFlightFences[currentFrame]);
+        vkResetFences(device, 1, &frame.inFlightFence);
+
+        // Poll the upload batches; the geometry is only drawn once its copy has finished on the transfer queue.
+        uploadManager.collect();
+        if (!geometryReady && uploadManager.isComplete(geometryUpload))
+        {
+            geometryReady = true;
+            invalidateCommandBuffers(); // The cached buffers recorded so far only clear the screen.
+        }
 
-        // Reset and record the command buffer for the current frame and image index.
-        vkResetCommandBuffer(commandBuffers[imageIndex], /*VkCommandBufferResetFlagBits*/ 0);
-        recordCommandBuffer(commandBuffers[imageIndex], imageIndex);
+        // Write the uniforms of this frame into its region of the arena; the returned offset is bound while recording.
+        uniformRing.beginFrame(frame.uniformRegion);
+        uint32_t uniformOffset = updateUniformBuffer();
+        if (renderPath == RenderPath::Instanced)
+        {
+            updateInstanceBuffer(frame.uniformRegion); // Same region index: the frame's fence protects both.
+        }
+        updateOverlay(frame.uniformRegion); // Same for the overlay quads.
 
-        // Update the uniform buffer for the current frame.
-        updateUniformBuffer(currentFrame);
+        // Reuse the cached command buffer of this frame and image unless one of its dependencies changed.
+        // Its previous submission has finished: it belongs to this frame, whose fence was waited on above.
+        VkCommandBuffer commandBuffer = frame.commandBuffers[imageIndex];
+        if (!commandBufferCacheEnabled || frame.recordedGenerations[imageIndex] != commandBufferGeneration || frame.recordedUniformOffsets[imageIndex] != uniformOffset)
+        {
+            double recordStart = getTime();
+            vkResetCommandBuffer(commandBuffer, /*VkCommandBufferResetFlagBits*/ 0);
+            recordCommandBuffer(frame, commandBuffer, imageIndex, uniformOffset);
+            recordTimeAccumulator += getTime() - recordStart;
+            recordTimeCount++;
+            frame.recordedGenerations[imageIndex] = commandBufferGeneration;
+            frame.recordedUniformOffsets[imageIndex] = uniformOffset;
+            recordedFrameCount++;
+        }
+        else
+        {
+            reusedFrameCount++;
+        }
 
         // Submit information to the graphics queue.
         VkSubmitInfo submitInfo{};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
         // Specify semaphores to wait on before execution.
-        VkSemaphore waitSemaphores[] = {imageAvailableSemaphores[currentFrame]};
+        VkSemaphore waitSemaphores[] = {frame.imageAvailableSemaphore};
         VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.waitSemaphoreCount = options.headless ? 0 : 1; // Nothing was acquired in headless mode.
         submitInfo.pWaitSemaphores = waitSemaphores;
         submitInfo.pWaitDstStageMask = waitStages;
 
         // Specify the command buffer to execute.
         submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffers[imageIndex];
+        submitInfo.pCommandBuffers = &commandBuffer;
 
         // Specify semaphores to signal after execution.
-        VkSemaphore signalSemaphores[] = {renderFinishedSemaphores[imageIndex]};
-        submitInfo.signalSemaphoreCount = 1;
+        VkSemaphore signalSemaphores[] = {options.headless ? VK_NULL_HANDLE : renderFinishedSemaphores[imageIndex]};
+        submitInfo.signalSemaphoreCount = options.headless ? 0 : 1; // Nothing is presented in headless mode.
         submitInfo.pSignalSemaphores = signalSemaphores;
 
         // Submit the command buffer to the graphics queue, signaling the fence upon completion.
-        if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) {
-            throw std::runtime_error("failed to submit draw command buffer!");
+        {
+            PROFILE_ZONE("vkQueueSubmit");
+            if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, frame.inFlightFence) != VK_SUCCESS) {
+                throw std::runtime_error("failed to submit draw command buffer!");
+            }
+        }
+        overdrawQueryPending[frame.uniformRegion] = isCountingOverdraw(); // Toggling the counter re-records, so the buffer matches.
+        gpuProfiler.frameSubmitted(frame.uniformRegion); // Cached buffers write the timestamps too.
+        submittedFrameStarts[frame.uniformRegion] = frameStart;
+        lastImageIndex = imageIndex;
+        renderedFrameCount++;
+
+        if (options.headless)
+        {
+            currentFrame = (currentFrame + 1) % framesInFlight; // Skip the present queue entirely.
+            return;
         }
 
         // Present information to the present queue.
@@ -1488,7 +3030,10 @@ private:
         presentInfo.pImageIndices = &imageIndex;
 
         // Queue the presentation operation.
-        result = vkQueuePresentKHR(presentQueue, &presentInfo);
+        {
+            PROFILE_ZONE("vkQueuePresentKHR");
+            result = vkQueuePresentKHR(presentQueue, &presentInfo);
+        }
 
         // Handle presentation results that require swap chain recreation.
         if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || framebufferResized) {
@@ -1498,13 +3043,49 @@ private:
             throw std::runtime_error("failed to present swap chain image!");
         }
 
-        // Advance to the next frame, wrapping around if MAX_FRAMES_IN_FLIGHT is reached.
-        currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+        // Advance to the next frame, wrapping around if framesInFlight is reached.
+        currentFrame = (currentFrame + 1) % framesInFlight;
     }
 
     // Records commands into a specific command buffer for rendering.
-    void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) 
+    // uniformOffset is the dynamic offset of the first object; object i uses uniformOffset + i * stride.
+    void recordCommandBuffer(FrameContext& frame, VkCommandBuffer commandBuffer, uint32_t imageIndex, uint32_t uniformOffset) 
     {
+        PROFILE_FUNCTION();
+        // Until the geometry upload has finished the frame only clears the screen.
+        bool drawsObjects = renderPath == RenderPath::DrawList || renderPath == RenderPath::Bindless;
+        bool drawScene = geometryReady && (drawsObjects ? visibleObjectCount > 0 : !instances.empty());
+        bool countOverdraw = isCountingOverdraw();
+        bool useSecondaries = drawScene && parallelRecording && renderPath == RenderPath::DrawList // A single draw is not worth splitting.
+                           && (!countOverdraw || inheritedQueriesSupported); // Secondaries may only run inside the query with inheritedQueries.
+
+        // Start recording the slices of the draw list on the workers while the primary buffer is recorded here.
+        std::vector<std::future<void>> recordingJobs;
+        std::vector<VkCommandBuffer> secondaryCommandBuffers;
+        if (useSecondaries)
+        {
+            size_t sliceCount = frame.workerCommandPools.size();
+            size_t objectsPerSlice = (visibleObjectCount + sliceCount - 1) / sliceCount;
+
+            for (size_t slice = 0; slice < sliceCount; slice++)
+            {
+                size_t first = slice * objectsPerSlice;
+                if (first >= visibleObjectCount)
+                {
+                    break;
+                }
+                size_t count = std::min(objectsPerSlice, visibleObjectCount - first);
+                bool drawOverlay = isDrawingOverlay() && first + count == visibleObjectCount; // The last slice draws it after the scene.
+
+                VkCommandBuffer secondary = frame.secondaryCommandBuffers[imageIndex][slice]; // Allocated from the pool of this slice only.
+                uint32_t slot = frame.uniformRegion;
+                secondaryCommandBuffers.push_back(secondary);
+                recordingJobs.push_back(recordingThreads.submit([this, secondary, imageIndex, first, count, uniformOffset, drawOverlay, slot]() {
+                    recordSecondaryCommandBuffer(secondary, imageIndex, first, count, uniformOffset, drawOverlay, slot);
+                }));
+            }
+        }
+
         // Begin recording commands into the command buffer.
         VkCommandBufferBeginInfo beginInfo{};
         beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -1516,6 +3097,23 @@ private:
             throw std::runtime_error("failed to begin recording command buffer!");
         }
 
+        gpuProfiler.beginFrame(commandBuffer, frame.uniformRegion); // Reset this slot's timestamps.
+
+        // The GPU-driven path builds its draw with a compute pass, which must run outside the render pass.
+        if (drawScene && renderPath == RenderPath::GpuDriven)
+        {
+            gpuProfiler.beginPass(commandBuffer, frame.uniformRegion, cullGpuPass);
+            recordDrawGeneration(commandBuffer, frame.uniformRegion, uniformOffset);
+            gpuProfiler.endPass(commandBuffer, frame.uniformRegion, cullGpuPass);
+        }
+
+        // The counter covers both subpasses, so it also sees the fragments of the depth pre-pass (none without a fragment shader).
+        if (countOverdraw)
+        {
+            vkCmdResetQueryPool(commandBuffer, overdrawQueryPool, frame.uniformRegion, 1);
+            vkCmdBeginQuery(commandBuffer, overdrawQueryPool, frame.uniformRegion, 0);
+        }
+
             // Begin the render pass.
             VkRenderPassBeginInfo renderPassInfo{};
             renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -1524,50 +3122,57 @@ private:
             renderPassInfo.renderArea.offset = {0, 0};                           // Offset for the render area.
             renderPassInfo.renderArea.extent = swapChainExtent;                  // Extent (size) for the render area.
 
-            // Clear value for the color attachment (black, opaque).
-            VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
-            renderPassInfo.clearValueCount = 1;         // Number of clear values.
-            renderPassInfo.pClearValues = &clearColor;  // Pointer to the clear values.
+            // Clear values for the color attachment (black, opaque) and the depth attachment (far plane).
+            std::array<VkClearValue, 2> clearValues{};
+            clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+            clearValues[1].depthStencil = {1.0f, 0};
+            renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size()); // Number of clear values.
+            renderPassInfo.pClearValues = clearValues.data();                           // Pointer to the clear values.
 
-            // Begin the render pass with inline command execution.
+            // Subpass 0: the depth pre-pass, recorded inline (it is empty while the pre-pass is off).
+            gpuProfiler.beginPass(commandBuffer, frame.uniformRegion, renderGpuPass);
             vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-                // Bind the graphics pipeline.
-                vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
-
-                // Set the dynamic viewport.
-                VkViewport viewport{};
-                viewport.x = 0.0f;
-                viewport.y = 0.0f;
-                viewport.width = (float) swapChainExtent.width;
-                viewport.height = (float) swapChainExtent.height;
-                viewport.minDepth = 0.0f;
-                viewport.maxDepth = 1.0f;
-                vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-
-                // Set the dynamic scissor rectangle.
-                VkRect2D scissor{};
-                scissor.offset = {0, 0};
-                scissor.extent = swapChainExtent;
-                vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-                // Bind the vertex buffer.
-                VkBuffer vertexBuffers[] = {vertexBuffer}; // Array of vertex buffers to bind.
-                VkDeviceSize offsets[] = {0}; // Offsets for each vertex buffer.
-                vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-                
-                // Bind the index buffer.
-                vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT16); // Bind the index buffer with 16-bit indices.
-
-                // Bind the descriptor set for the current image.
-                vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSets[imageIndex], 0, nullptr);
+                if (drawScene && depthPrePassPipeline != VK_NULL_HANDLE)
+                {
+                    recordScene(commandBuffer, depthPrePassPipeline, frame.uniformRegion, uniformOffset);
+                }
 
-                // Draw the indexed triangle.
-                // In this case, we draw a single instance of the triangle using the indices defined in the index buffer.
-                vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
+            // Subpass 1: the shaded scene.
+            if (useSecondaries)
+            {
+                // The subpass contents come entirely from the secondary command buffers.
+                vkCmdNextSubpass(commandBuffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+                    for (auto& job : recordingJobs)
+                    {
+                        job.get(); // Wait for the slice (rethrows recording errors).
+                    }
+                    vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(secondaryCommandBuffers.size()), secondaryCommandBuffers.data());
+            }
+            else
+            {
+                // Continue with inline command execution.
+                vkCmdNextSubpass(commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+
+                    if (drawScene)
+                    {
+                        recordScene(commandBuffer, graphicsPipeline, frame.uniformRegion, uniformOffset);
+                    }
+                    if (isDrawingOverlay())
+                    {
+                        recordOverlay(commandBuffer, frame.uniformRegion);
+                    }
+            }
 
             // End the render pass.
             vkCmdEndRenderPass(commandBuffer);
+            gpuProfiler.endPass(commandBuffer, frame.uniformRegion, renderGpuPass);
+
+        if (countOverdraw)
+        {
+            vkCmdEndQuery(commandBuffer, overdrawQueryPool, frame.uniformRegion);
+        }
 
         // End recording commands into the command buffer.
         if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
@@ -1575,6 +3180,227 @@ private:
         }
     }
 
+    // Records a slice of the draw list into a secondary command buffer that continues the render pass, followed by the
+    // overlay of frame slot overlaySlot if drawOverlay is set (the primary buffer cannot draw inline in this subpass).
+    // Runs on a worker thread: it only reads application state and writes a buffer owned by its slice.
+    void recordSecondaryCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, size_t firstObject, size_t objectCount, uint32_t uniformOffset,
+                                      bool drawOverlay, uint32_t overlaySlot)
+    {
+        PROFILE_FUNCTION(); // Shows up on the worker thread's track.
+        // The secondary buffer inherits the render pass, color subpass and framebuffer of the primary buffer,
+        // and runs inside the overdraw query when it is active.
+        VkCommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.renderPass = renderPass;
+        inheritanceInfo.subpass = 1;
+        inheritanceInfo.framebuffer = swapChainFramebuffers[imageIndex];
+        inheritanceInfo.pipelineStatistics = isCountingOverdraw() ? VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT : 0;
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT; // Executed entirely inside a render pass.
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        vkResetCommandBuffer(commandBuffer, 0);
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+            throw std::runtime_error("failed to begin recording command buffer!");
+        }
+
+        recordSceneDraws(commandBuffer, graphicsPipeline, firstObject, objectCount, uniformOffset);
+        if (drawOverlay)
+        {
+            recordOverlay(commandBuffer, overlaySlot);
+        }
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("failed to record command buffer!");
+        }
+    }
+
+    // True while the overdraw counter is recorded into the command buffers.
+    bool isCountingOverdraw() const
+    {
+        return overdrawCounterEnabled && overdrawQueryPool != VK_NULL_HANDLE;
+    }
+
+    // Records the whole scene of the current render path with a pipeline: the depth-only one in the pre-pass, the
+    // selected variant in the color subpass.
+    void recordScene(VkCommandBuffer commandBuffer, VkPipeline pipeline, uint32_t slot, uint32_t uniformOffset)
+    {
+        if (renderPath == RenderPath::Instanced)
+        {
+            recordInstancedDraw(commandBuffer, pipeline, slot, uniformOffset);
+        }
+        else if (renderPath == RenderPath::GpuDriven)
+        {
+            recordIndirectDraw(commandBuffer, pipeline, slot, uniformOffset);
+        }
+        else if (renderPath == RenderPath::Bindless)
+        {
+            recordBindlessDraw(commandBuffer, pipeline, uniformOffset);
+        }
+        else
+        {
+            recordSceneDraws(commandBuffer, pipeline, 0, visibleObjectCount, uniformOffset);
+        }
+    }
+
+    // Records the state setup and the draw calls of a range of the draw list.
+    void recordSceneDraws(VkCommandBuffer commandBuffer, VkPipeline pipeline, size_t firstObject, size_t objectCount, uint32_t uniformOffset)
+    {
+        // Bind the graphics pipeline.
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        setViewportAndScissor(commandBuffer);
+
+        // Bind the vertex buffer.
+        VkBuffer vertexBuffers[] = {vertexBuffer}; // Array of vertex buffers to bind.
+        VkDeviceSize offsets[] = {0}; // Offsets for each vertex buffer.
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+        
+        // Bind the index buffer.
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, indexType); // Bind the index buffer (16- or 32-bit indices).
+
+        for (size_t i = firstObject; i < firstObject + objectCount; i++)
+        {
+            // Bind the uniform arena; the dynamic offset selects the UniformBufferObject of this object in this frame.
+            uint32_t objectOffset = uniformOffset + static_cast<uint32_t>(i * uniformRing.getStride());
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 1, &objectOffset);
+
+            // Draw the indexed quad of this object.
+            vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
+        }
+    }
+
+    // Records the visible draw list as one merged draw: the objects share the mesh, and instance i reads uniform
+    // entry i through the bindless set. One descriptor bind and one push constant replace a bind per object.
+    void recordBindlessDraw(VkCommandBuffer commandBuffer, VkPipeline pipeline, uint32_t uniformOffset)
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        setViewportAndScissor(commandBuffer);
+
+        VkBuffer vertexBuffers[] = {vertexBuffer};
+        VkDeviceSize offsets[] = {0};
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, indexType);
+
+        VkDescriptorSet set = bindlessSet.getSet();
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, bindlessPipelineLayout, 0, 1, &set, 0, nullptr);
+
+        // The stride is sizeof(UniformBufferObject) (208 bytes, a multiple of 16) rounded up to the power-of-two
+        // minUniformBufferOffsetAlignment, so it is a multiple of 16 whatever the alignment; offsets are multiples of it.
+        BindlessPushConstants pushConstants{};
+        pushConstants.objectBuffer = uniformArenaSlot;
+        pushConstants.firstObject = uniformOffset / 16;
+        pushConstants.objectStride = static_cast<uint32_t>(uniformRing.getStride() / 16);
+        vkCmdPushConstants(commandBuffer, bindlessPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pushConstants), &pushConstants);
+
+        vkCmdDrawIndexed(commandBuffer, indexCount, static_cast<uint32_t>(visibleObjectCount), 0, 0, 0);
+    }
+
+    // Records the whole instance grid as one instanced draw. The instance buffer is bound at the region of this frame,
+    // which never changes for a frame slot, so the cached command buffers stay valid while the data is rewritten.
+    void recordInstancedDraw(VkCommandBuffer commandBuffer, VkPipeline pipeline, uint32_t instanceRegion, uint32_t uniformOffset)
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        setViewportAndScissor(commandBuffer);
+
+        // Binding 0 advances per vertex, binding 1 per instance.
+        VkBuffer vertexBuffers[] = {vertexBuffer, instanceBuffer};
+        VkDeviceSize offsets[] = {0, sizeof(InstanceData) * instances.size() * instanceRegion};
+        vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, offsets);
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, indexType);
+
+        // One uniform entry (camera, identity model) for the whole grid.
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 1, &uniformOffset);
+        vkCmdDrawIndexed(commandBuffer, indexCount, static_cast<uint32_t>(instances.size()), 0, 0, 0);
+    }
+
+    // Records the culling pass of the GPU-driven path: resets the indirect command of this frame slot, culls the
+    // object table into the slot's visible instance buffer and makes both visible to the indirect draw.
+    // Nothing in here depends on the object count beyond the dispatch size, so it is recorded once and cached.
+    void recordDrawGeneration(VkCommandBuffer commandBuffer, uint32_t slot, uint32_t uniformOffset)
+    {
+        VkDrawIndexedIndirectCommand resetCommand{};
+        resetCommand.indexCount = indexCount;
+        resetCommand.instanceCount = 0; // Incremented by every visible object.
+        vkCmdUpdateBuffer(commandBuffer, drawCommandBuffers[slot], 0, sizeof(resetCommand), &resetCommand);
+
+        VkMemoryBarrier resetBarrier{};
+        resetBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        resetBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        resetBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &resetBarrier, 0, nullptr, 0, nullptr);
+
+        CullPushConstants pushConstants{};
+        pushConstants.objectCount = static_cast<uint32_t>(instances.size());
+        pushConstants.meshRadius = meshRadius;
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipelineLayout, 0, 1, &cullDescriptorSets[slot], 1, &uniformOffset);
+        vkCmdPushConstants(commandBuffer, cullPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+        vkCmdDispatch(commandBuffer, (pushConstants.objectCount + 63) / 64, 1, 1); // local_size_x = 64 in cull.comp.
+
+        // The indirect command and the compacted instances are consumed by the draw in the render pass.
+        VkMemoryBarrier drawBarrier{};
+        drawBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        drawBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        drawBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                             0, 1, &drawBarrier, 0, nullptr, 0, nullptr);
+    }
+
+    // Records the single indirect draw of the GPU-driven path; the instance count comes from the culling pass.
+    void recordIndirectDraw(VkCommandBuffer commandBuffer, VkPipeline pipeline, uint32_t slot, uint32_t uniformOffset)
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        setViewportAndScissor(commandBuffer);
+
+        VkBuffer vertexBuffers[] = {vertexBuffer, visibleInstanceBuffers[slot]};
+        VkDeviceSize offsets[] = {0, 0};
+        vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, offsets);
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, indexType);
+
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 1, &uniformOffset);
+        vkCmdDrawIndexedIndirect(commandBuffer, drawCommandBuffers[slot], 0, 1, sizeof(VkDrawIndexedIndirectCommand));
+    }
+
+    // Records the frame statistics overlay as one draw over the color subpass. The vertex buffer is bound at the
+    // region of this frame slot, so the cached command buffers stay valid while updateOverlay rewrites the quads.
+    void recordOverlay(VkCommandBuffer commandBuffer, uint32_t slot)
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, overlayPipeline);
+        setViewportAndScissor(commandBuffer);
+
+        VkDeviceSize offset = sizeof(OverlayVertex) * OVERLAY_VERTEX_COUNT * slot;
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &overlayVertexBuffer, &offset);
+        vkCmdDraw(commandBuffer, OVERLAY_VERTEX_COUNT, 1, 0, 0);
+    }
+
+    // True while the overlay draw is recorded into the command buffers.
+    bool isDrawingOverlay() const
+    {
+        return frameStatsOverlayEnabled && overlayPipeline != VK_NULL_HANDLE;
+    }
+
+    // Sets the dynamic viewport and scissor to the whole swap chain image.
+    void setViewportAndScissor(VkCommandBuffer commandBuffer)
+    {
+        // Set the dynamic viewport.
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = (float) swapChainExtent.width;
+        viewport.height = (float) swapChainExtent.height;
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+        // Set the dynamic scissor rectangle.
+        VkRect2D scissor{};
+        scissor.offset = {0, 0};
+        scissor.extent = swapChainExtent;
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    }
+
     // Recreates the swap chain and related resources after a window resize or swap chain becoming out-of-date.
     void recreateSwapChain() 
     {
@@ -1593,28 +3419,97 @@ private:
 
         createSwapChain();    // Create a new swap chain.
         createImageViews();   // Create new image views for the new swap chain images.
+        createDepthResources(); // Create a depth buffer of the new extent.
         createFramebuffers(); // Create new framebuffers for the new image views.
-        // Command buffers don't need to be recreated because they don't depend on swap chain images directly,
-        // only on the render pass and framebuffers, which are recreated.
+        createPresentSemaphores(); // The image count may have changed.
+        allocateCachedCommandBuffers(); // Make room for new swap chain images.
+        invalidateCommandBuffers(); // The framebuffers and extent baked into the cached buffers are gone.
     }
 
-    // Updates the uniform buffer with the current transformation matrix.
-    void updateUniformBuffer(uint32_t currentImage) 
+    // Writes the transformation matrices of every object into the uniform arena and returns the dynamic offset of the first one.
+    uint32_t updateUniformBuffer() 
     {
-        static auto startTime = std::chrono::high_resolution_clock::now(); // Start measuring time.
+        PROFILE_FUNCTION();
+        float time = getAnimationTime(); // Elapsed time in seconds.
 
-        auto currentTime = std::chrono::high_resolution_clock::now(); // Get the current time.
-        float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count(); // Calculate elapsed time in seconds.
+        // The camera only changes with the extent; the object bounds are static, so the cull result is only
+        // recomputed along with it. A static camera costs one comparison per frame.
+        if (swapChainExtent.width != cameraExtent.width || swapChainExtent.height != cameraExtent.height)
+        {
+            updateCamera();
+        }
 
-        // Create a transformation matrix that rotates the triangle over time.
         UniformBufferObject ubo{};
-        ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)); // Rotate around the Z-axis.
-        ubo.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)); // Set the view matrix.
-        ubo.proj = glm::perspective(glm::radians(45.0f), (float) swapChainExtent.width / (float) swapChainExtent.height, 0.1f, 10.0f); // Set the projection matrix.
-        ubo.proj[1][1] *= -1; // Invert the Y-axis for Vulkan's coordinate system.
+        ubo.view = cameraView;
+        ubo.proj = cameraProjection;
+        ubo.animation = glm::vec4(time, 0.0f, 0.0f, 0.0f);
+
+        if (renderPath == RenderPath::Instanced || renderPath == RenderPath::GpuDriven)
+        {
+            ubo.model = glm::mat4(1.0f); // The instances carry their own placement.
+            return uniformRing.push(&ubo);
+        }
+
+        // Only visible objects are animated: their local matrices are written directly (no translate / rotate / scale
+        // chain) and the hierarchy recomputes just those world matrices, in SIMD batches.
+        float angle = time * glm::radians(90.0f);
+        for (size_t i = 0; i < visibleObjectCount; i++)
+        {
+            const SceneObject& object = sceneObjects[visibleObjects[i]];
+            float c = std::cos(angle + object.phase) * object.scale;
+            float s = std::sin(angle + object.phase) * object.scale;
+            const float local[16] = {
+                c,    s,    0.0f,         0.0f,  // Rotated and scaled X axis.
+                -s,   c,    0.0f,         0.0f,  // Rotated and scaled Y axis.
+                0.0f, 0.0f, object.scale, 0.0f,  // Scaled Z axis.
+                object.position.x, object.position.y, 0.0f, 1.0f // Grid cell.
+            };
+            sceneTransforms.setLocal(object.transform, local);
+        }
+        sceneTransforms.update();
+
+        uint32_t firstOffset = 0;
+        for (size_t i = 0; i < visibleObjectCount; i++)
+        {
+            const SceneObject& object = sceneObjects[visibleObjects[i]];
+            ubo.model = glm::make_mat4(sceneTransforms.getWorld(object.transform));
 
-        // Copy the updated uniform buffer data to the mapped memory.
-        memcpy(uniformBuffersMapped[currentImage], &ubo, sizeof(ubo)); // Copy the uniform buffer object data to the mapped memory.
+            // Copy the uniform data into the next entry of the current frame's region (entries are contiguous).
+            uint32_t offset = uniformRing.push(&ubo);
+            if (i == 0)
+            {
+                firstOffset = offset;
+            }
+        }
+
+        return firstOffset;
+    }
+
+    // Rebuilds the camera matrices for the current extent and culls the draw list against them. The visible count is
+    // baked into the cached command buffers, so they are rerecorded when it changes.
+    void updateCamera()
+    {
+        cameraExtent = swapChainExtent;
+        cameraView = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)); // Set the view matrix.
+        cameraProjection = glm::perspective(glm::radians(45.0f), (float) swapChainExtent.width / (float) swapChainExtent.height, 0.1f, 10.0f); // Set the projection matrix.
+        cameraProjection[1][1] *= -1; // Invert the Y-axis for Vulkan's coordinate system.
+        cameraViewProjection = cameraProjection * cameraView;
+
+        size_t visibleCount = sceneCuller.cull(glm::value_ptr(cameraViewProjection), BoundsShape::Sphere, visibleObjects);
+        if (visibleCount != visibleObjectCount)
+        {
+            visibleObjectCount = visibleCount;
+            invalidateCommandBuffers();
+        }
+    }
+
+    // Seconds since the first frame, shared by the uniform and instance animations.
+    float getAnimationTime()
+    {
+        static auto startTime = std::chrono::high_resolution_clock::now(); // Start measuring time.
+
+        auto currentTime = std::chrono::high_resolution_clock::now(); // Get the current time.
+        return std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count(); // Calculate elapsed time in seconds.
     }
 
     # pragma endregion
@@ -1622,6 +3517,20 @@ private:
     // Cleans up Vulkan and GLFW resources.
     # pragma region Cleanup()
 
+    // Destroys the resources of every frame in flight.
+    void destroyFrameContexts()
+    {
+        for (auto& frame : frames) {
+            vkDestroySemaphore(device, frame.imageAvailableSemaphore, nullptr);
+            vkDestroyFence(device, frame.inFlightFence, nullptr);
+            vkDestroyCommandPool(device, frame.commandPool, nullptr); // Also frees the frame's cached command buffers.
+            for (auto workerPool : frame.workerCommandPools) {
+                vkDestroyCommandPool(device, workerPool, nullptr); // Also frees the secondary command buffers of the slice.
+            }
+        }
+        frames.clear();
+    }
+
     // Cleans up swap chain-related resources.
     void cleanupSwapChain() {
         // Destroy all framebuffers created for the swap chain.
@@ -1634,54 +3543,97 @@ private:
             vkDestroyImageView(device, imageView, nullptr);
         }
 
-        // Destroy the Vulkan swap chain.
+        // Destroy the render finished semaphores, which are tied to the swap chain images.
+        for (auto semaphore : renderFinishedSemaphores) {
+            vkDestroySemaphore(device, semaphore, nullptr);
+        }
+        renderFinishedSemaphores.clear();
+
+        // Destroy the depth buffer, which has the extent of the swap chain.
+        vkDestroyImageView(device, depthImageView, nullptr);
+        vkDestroyImage(device, depthImage, nullptr);
+        memoryAllocator.free(depthImageAllocation);
+
+        // Destroy the offscreen images standing in for the swap chain, or the Vulkan swap chain.
+        if (options.headless)
+        {
+            for (size_t i = 0; i < swapChainImages.size(); i++) {
+                vkDestroyImage(device, swapChainImages[i], nullptr);
+                memoryAllocator.free(offscreenImageAllocations[i]);
+            }
+            swapChainImages.clear();
+            offscreenImageAllocations.clear();
+            return;
+        }
         vkDestroySwapchainKHR(device, swapChain, nullptr);
     }
 
     // Cleans up all allocated Vulkan and GLFW resources.
     void cleanup()
     {
+        memoryTelemetry.printSummary(std::cout); // While every resource is still alive.
         cleanupSwapChain(); // Call the function to clean up swap chain resources.
 
-        // Destroy uniform buffers and free their memory.
-        for (size_t i = 0; i < swapChainImages.size(); i++) {
-            vkDestroyBuffer(device, uniformBuffers[i], nullptr); // Destroy the uniform buffer.
-            vkFreeMemory(device, uniformBuffersMemory[i], nullptr); // Free the memory allocated for the uniform buffer.
-        }
+        // Destroy the uniform arena and free its memory.
+        uniformRing.cleanup();
 
         vkDestroyDescriptorPool(device, descriptorPool, nullptr); // Destroy the descriptor pool.
 
         // Destroy the descriptor set layout.
         vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr); // Destroy the descriptor set layout.
 
-        // Destroy the index buffer and its memory.
-        vkDestroyBuffer(device, indexBuffer, nullptr); // Destroy the index buffer.
-        vkFreeMemory(device, indexBufferMemory, nullptr); // Free the memory allocated for the index buffer.
+        // Destroy the culling pass of the GPU-driven path (its descriptor sets go with the pool).
+        vkDestroyPipeline(device, cullPipeline, nullptr);
+        vkDestroyPipelineLayout(device, cullPipelineLayout, nullptr);
+        vkDestroyDescriptorSetLayout(device, cullDescriptorSetLayout, nullptr);
 
-        vkDestroyBuffer(device, vertexBuffer, nullptr); // Destroy the vertex buffer.
-        vkFreeMemory(device, vertexBufferMemory, nullptr); // Free the memory allocated for the vertex buffer.
+        // Destroy the GPU-driven, instance, index and vertex buffers, returning their memory to the allocator.
+        for (uint32_t slot = 0; slot < MAX_FRAMES_IN_FLIGHT; slot++)
+        {
+            destroyBuffer(drawCommandBuffers[slot], drawCommandAllocations[slot]);
+            destroyBuffer(visibleInstanceBuffers[slot], visibleInstanceAllocations[slot]);
+        }
+        destroyBuffer(objectTableBuffer, objectTableAllocation); // Destroy the object table.
+        destroyBuffer(instanceBuffer, instanceBufferAllocation); // Destroy the instance buffer.
+        destroyBuffer(overlayVertexBuffer, overlayVertexAllocation); // Destroy the overlay quads.
+        destroyBuffer(indexBuffer, indexBufferAllocation); // Destroy the index buffer.
+        destroyBuffer(vertexBuffer, vertexBufferAllocation); // Destroy the vertex buffer.
 
         // Destroy the graphics pipeline, pipeline layout, and render pass.
-        vkDestroyPipeline(device, graphicsPipeline, nullptr); // Destroy the graphics pipeline.
+        pipelineBuilder.cleanup(); // Wait for the variants still compiling and destroy every pipeline.
+        instancedPipelineBuilder.cleanup();
+        bindlessPipelineBuilder.cleanup();
+        overlayPipelineBuilder.cleanup();
+        pipelineThreads.cleanup(); // Join the compilation workers.
+        vkDestroyShaderModule(device, fragShaderModule, nullptr); // The shader modules were kept for the variants.
+        vkDestroyShaderModule(device, instancedVertShaderModule, nullptr);
+        vkDestroyShaderModule(device, vertShaderModule, nullptr);
+        vkDestroyShaderModule(device, bindlessVertShaderModule, nullptr);
+        vkDestroyShaderModule(device, overlayVertShaderModule, nullptr);
         vkDestroyPipelineLayout(device, pipelineLayout, nullptr); // Destroy the pipeline layout.
+        vkDestroyPipelineLayout(device, bindlessPipelineLayout, nullptr);
+        if (bindlessSupported)
+        {
+            bindlessSet.cleanup(); // Destroy the bindless set, its pool and its layout.
+        }
         vkDestroyRenderPass(device, renderPass, nullptr); // Destroy the render pass.
+        pipelineCache.cleanup(); // Save the pipeline cache for the next launch and destroy it.
+        shaderPack.close();      // Unmap the shader pack.
 
-        // Destroy synchronization objects for each frame in flight.
-        for (size_t i = 0; i < renderFinishedSemaphores.size(); i++) {
-            vkDestroySemaphore(device, renderFinishedSemaphores[i], nullptr);
-        }
-        for (size_t i = 0; i < imageAvailableSemaphores.size(); i++) {
-            vkDestroySemaphore(device, imageAvailableSemaphores[i], nullptr);
-        }
-        for (size_t i = 0; i < inFlightFences.size(); i++) {
-            vkDestroyFence(device, inFlightFences[i], nullptr);
-        }
+        // Destroy the command pools and synchronization objects of each frame in flight.
+        destroyFrameContexts();
+        vkDestroyQueryPool(device, overdrawQueryPool, nullptr); // Destroy the overdraw counters.
+        gpuProfiler.cleanup(); // Destroy the timestamp pools.
+        frameStats.stop(); // Join the frame statistics reader.
+        recordingThreads.cleanup(); // Join the recording workers.
 
-        renderFinishedSemaphores.clear(); // Clear the render finished semaphores vector.
-        imageAvailableSemaphores.clear(); // Clear the image available semaphores vector.
-        inFlightFences.clear(); // Clear the in-flight fences vector.
+        uploadManager.cleanup(); // Wait for the remaining uploads and release their staging memory.
 
-        vkDestroyCommandPool(device, commandPool, nullptr); // Destroy the command pool.
+        // Report how the device memory was used, then release the remaining blocks.
+        std::cout << "Command buffers: " << recordedFrameCount << " frames recorded, " << reusedFrameCount << " frames reused a cached buffer" << std::endl;
+        memoryAllocator.printStatistics(std::cout);
+        memoryAllocator.cleanup();
+        memoryAllocator.setTelemetry(nullptr);
 
         // Destroy the Vulkan logical device.
         vkDestroyDevice(device, nullptr);
@@ -1692,17 +3644,21 @@ private:
             DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
         }
 
-        // Destroy the Vulkan surface associated with the GLFW window.
+        // Destroy the Vulkan surface associated with the GLFW window (VK_NULL_HANDLE in headless mode).
         vkDestroySurfaceKHR(instance, surface, nullptr);
 
         // Destroy the Vulkan instance.
         vkDestroyInstance(instance, nullptr);
 
-        // Destroy the GLFW window.
-        glfwDestroyWindow(window);
+        // Headless mode never initialized GLFW.
+        if (!options.headless)
+        {
+            // Destroy the GLFW window.
+            glfwDestroyWindow(window);
 
-        // Terminate GLFW.
-        glfwTerminate();
+            // Terminate GLFW.
+            glfwTerminate();
+        }
     }
 
     # pragma endregion
@@ -1711,9 +3667,9 @@ private:
 
 // Create a EPIC EXTREME ULTRA MEGA standard FUDEROSO triangle in Vulkan
 // This is the main function where the application execution begins.
-int triangle()
+int triangle(const RunOptions& options)
 {
-    HelloTriangleApplication app; // Create an instance of the HelloTriangleApplication class.
+    HelloTriangleApplication app(options); // Create an instance of the HelloTriangleApplication class.
     // I call it triangle application, but turns out it's a training for the whole Vulkan Tutorial in a single file.
 
     try
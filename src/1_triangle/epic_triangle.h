@@ -2,6 +2,8 @@
 #ifndef EPIC_TRIANGLE_H
 #define EPIC_TRIANGLE_H
 
-int triangle(); // Apenas a declaracao da funcao triangle
+#include "benchmark.h"  // Opcoes de execucao compartilhadas (RunOptions)
+
+int triangle(const RunOptions& options = RunOptions()); // Apenas a declaracao da funcao triangle
 
 #endif
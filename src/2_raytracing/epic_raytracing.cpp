@@ -29,6 +29,8 @@
 #include <cstdint>                  //Necessary for uint32_t
 #include <limits>                   //Necessary for std::numeric_limits
 #include <algorithm>                //Necessary for std::clamp
+#include <chrono>                   // For timing the loop iterations
+#include <string>                   // For std::string (device extension names)
 
 #pragma endregion
 
@@ -36,10 +38,12 @@
 // This section defines constants and global variables used throughout the application.
 #pragma region Constants and Global Variables
 
-// Define the width of the application window
+// Define the default width of the application window (--width)
 const uint32_t WIDTH = 800;
-// Define the height of the application window
+// Define the default height of the application window (--height)
 const uint32_t HEIGHT = 600;
+// Loop iterations of a headless run when no frame count is given
+const uint32_t HEADLESS_DEFAULT_FRAMES = 100;
 
 // A vector of C-style strings containing the names of Vulkan validation layers to enable.
 // These layers provide debugging and error checking for Vulkan API usage.
@@ -95,16 +99,38 @@ struct SwapChainSupportDetails
 class HelloRayTracingApplication
 {
 public:
+    // Stores the run options; a headless run without a frame count runs HEADLESS_DEFAULT_FRAMES iterations.
+    explicit HelloRayTracingApplication(const RunOptions& runOptions) : options(runOptions)
+    {
+        if (options.headless && options.frameCount == 0)
+        {
+            options.frameCount = HEADLESS_DEFAULT_FRAMES;
+        }
+        options.width = options.width != 0 ? options.width : WIDTH;
+        options.height = options.height != 0 ? options.height : HEIGHT;
+    }
+
     void run()
     {
-        initWindow();     // Initialize the GLFW window.
+        benchmark.start(options.warmupFrames); // Startup is measured from here to the first frame.
+        initWindow();     // Initialize the GLFW window (nothing in headless mode).
         initVulkan();     // Initialize Vulkan components.
-
-        // Main loop: mantém a janela aberta até o usuário fechar
-        while (!glfwWindowShouldClose(window)) {
-            glfwPollEvents();
+        benchmark.markStartupComplete();
+
+        // Main loop: mantém a janela aberta até o usuário fechar (ou até o número de frames pedido)
+        // Nothing is rendered yet, so a frame is one iteration of the event loop.
+        uint32_t frames = 0;
+        while (!(options.frameCount > 0 && frames >= options.warmupFrames + options.frameCount)
+               && (options.headless || !glfwWindowShouldClose(window))) {
+            auto frameStart = std::chrono::steady_clock::now();
+            if (!options.headless) {
+                glfwPollEvents();
+            }
+            benchmark.recordFrame(std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count());
+            frames++;
         }
 
+        benchmark.writeReport("raytracing", options, options.width, options.height, "none"); // No swap chain yet.
         cleanup();        // Clean up Vulkan and GLFW resources.
     }
 
@@ -114,7 +140,9 @@ private:
     // queues, swap chain, and other Vulkan objects.
     // These variables are used to manage the Vulkan rendering pipeline and resources.
     #pragma region Private Member Variables
-    GLFWwindow* window = nullptr;                                   // Pointer to the GLFW window object.
+    RunOptions options;                                             // Run options (headless mode, frame counts, resolution, report).
+    BenchmarkRecorder benchmark;                                    // Startup and per-frame times of the run, reported at exit.
+    GLFWwindow* window = nullptr;                                   // Pointer to the GLFW window object (nullptr in headless mode).
     VkInstance instance = VK_NULL_HANDLE;                           // Vulkan instance handle.
     VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;       // Vulkan debug messenger object.
     VkSurfaceKHR surface = VK_NULL_HANDLE;                          // Vulkan surface for rendering to the window.
@@ -130,10 +158,18 @@ private:
     // Initializes the GLFW window.
     void initWindow()
     {
+        if (options.headless)
+        {
+            return; // Nothing is shown: GLFW is never initialized, so no display server is needed.
+        }
+
         #if defined(_WIN32) || defined(_WIN64)
             // No platform hint needed for Windows
         #elif defined(__linux__)
-            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_X11); // Set X11 platform for Linux
+            if (getenv("DISPLAY") != nullptr)
+            {
+                glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_X11); // Prefer X11 (or XWayland) when an X display is available
+            }
         #endif
         glfwInit(); // Initialize the GLFW library.
 
@@ -144,7 +180,7 @@ private:
         glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE); // Removed to allow resizing
 
         // Create the GLFW window with specified width, height, title, and no full-screen or sharing.
-        window = glfwCreateWindow(WIDTH, HEIGHT, "Traçando Raio", nullptr, nullptr);
+        window = glfwCreateWindow(static_cast<int>(options.width), static_cast<int>(options.height), "Traçando Raio", nullptr, nullptr);
 
         // Set the user pointer for the window to this HelloTriangleApplication instance,
         // allowing access to its members from static callbacks.
@@ -259,13 +295,15 @@ private:
     // Retrieves the list of required Vulkan instance extensions.
     std::vector<const char*> getRequiredExtensions()
     {
-        uint32_t glfwExtensionCount = 0;
-        const char** glfwExtensions;
-        // Get the extensions required by GLFW for window surface creation.
-        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-        // Create a vector from the GLFW required extensions.
-        std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        // Headless mode creates no surface, so it needs no WSI extension (software drivers may not offer one).
+        std::vector<const char*> extensions;
+        if (!options.headless)
+        {
+            uint32_t glfwExtensionCount = 0;
+            // Get the extensions required by GLFW for window surface creation.
+            const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
         // If validation layers are enabled, add the debug utility extension.
         if (enableValidationLayers)
@@ -328,6 +366,11 @@ private:
     // Creates a Vulkan surface for rendering to the GLFW window.
     void createSurface() 
     {
+        if (options.headless)
+        {
+            return; // Nothing is presented.
+        }
+
         // Check if the GLFW window is valid before creating the surface.
         if (glfwCreateWindowSurface(instance, window, nullptr, &surface) != VK_SUCCESS) 
         {
@@ -380,9 +423,9 @@ private:
         QueueFamilyIndices indices = findQueueFamilies(device); // Find the queue families supported by the device.
         bool extensionsSupported = checkDeviceExtensionSupport(device); // Check if the required device extensions are supported.
 
-        // Check if the swap chain is adequate for the device.
-        bool swapChainAdequate = false;
-        if (extensionsSupported)
+        // Check if the swap chain is adequate for the device (headless mode has no swap chain).
+        bool swapChainAdequate = options.headless;
+        if (extensionsSupported && !options.headless)
         {
             SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device);
             swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
@@ -400,6 +443,12 @@ private:
         return indices.isComplete() && extensionsSupported && swapChainAdequate; // && requiredFeaturesSupported;
     }
 
+    // Device extensions the device must support: the swap chain, unless nothing is presented.
+    std::vector<const char*> getRequiredDeviceExtensions()
+    {
+        return options.headless ? std::vector<const char*>() : deviceExtensions;
+    }
+
     // Checks if the required Vulkan validation layers are supported by the system.
     bool checkDeviceExtensionSupport(VkPhysicalDevice device)
     {
@@ -413,7 +462,8 @@ private:
         // Get the properties of all available device extensions.
         vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
         // Create a set from the required device extensions for easy lookup.
-        std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
+        std::vector<const char*> requiredDeviceExtensions = getRequiredDeviceExtensions();
+        std::set<std::string> requiredExtensions(requiredDeviceExtensions.begin(), requiredDeviceExtensions.end());
         // Iterate through each available extension.
         for (const auto& extension : availableExtensions)
         {
@@ -486,8 +536,9 @@ private:
 
         createInfo.pEnabledFeatures = &enabledFeatures;
 
-        createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());;
-        createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+        std::vector<const char*> enabledExtensions = getRequiredDeviceExtensions();
+        createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+        createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
         // Enable validation layers if requested
         if (enableValidationLayers) 
@@ -536,8 +587,16 @@ private:
             }
 
             // Check if the queue family supports presenting images to a surface.
+            // Headless mode never presents, so the graphics family stands in for the present family.
             VkBool32 presentSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+            if (options.headless)
+            {
+                presentSupport = indices.graphicsFamily == static_cast<uint32_t>(i);
+            }
+            else
+            {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+            }
 
             // If the queue family supports presenting, store its index.
             if (presentSupport) 
@@ -570,8 +629,10 @@ private:
             window = nullptr; // Set the window pointer to nullptr after destruction.
         }
 
-        // Terminate GLFW.
-        glfwTerminate();
+        // Terminate GLFW (never initialized in headless mode).
+        if (!options.headless) {
+            glfwTerminate();
+        }
     }
     #pragma endregion
 
@@ -579,9 +640,9 @@ private:
 
 // Create a EPIC EXTREME ULTRA MEGA standard FUDEROSO ray tracing in Vulkan
 // This is the main function where the application execution begins.
-int raytrace()
+int raytrace(const RunOptions& options)
 {
-    HelloRayTracingApplication app; // Create an instance of the HelloRayTracingApplication class.
+    HelloRayTracingApplication app(options); // Create an instance of the HelloRayTracingApplication class.
 
     try
     {
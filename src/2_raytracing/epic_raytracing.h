@@ -2,6 +2,8 @@
 #ifndef EPIC_RAYTRACING_H
 #define EPIC_RAYTRACING_H
 
-int raytrace(); // Apenas a declaracao da funcao raytrace
+#include "benchmark.h"  // Opcoes de execucao compartilhadas (RunOptions)
+
+int raytrace(const RunOptions& options = RunOptions()); // Apenas a declaracao da funcao raytrace
 
 #endif
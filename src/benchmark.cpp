@@ -0,0 +1,182 @@
+// Region: Includes
+// This section includes the benchmark header and the standard headers it needs.
+#pragma region Includes
+
+// benchmark.cpp
+#include "benchmark.h"              // Include the header file for this module
+
+#include <algorithm>                // For std::sort / std::min_element / std::max_element
+#include <cmath>                    // For std::ceil
+#include <fstream>                  // For writing the report to a file
+#include <cstdio>                   // For writing the report to the C stdout stream
+#include <sstream>                  // For building the report before writing it
+#include <stdexcept>                // For standard exception handling (e.g., std::runtime_error)
+
+#pragma endregion
+
+// Region: Present Modes
+// This section converts present modes from and to their command line spelling.
+#pragma region Present Modes
+
+struct PresentModeName
+{
+    PresentModeOption presentMode;
+    const char* name;
+};
+
+static const PresentModeName PRESENT_MODE_NAMES[] =
+{
+    {PresentModeOption::Default, "default"},
+    {PresentModeOption::Immediate, "immediate"},
+    {PresentModeOption::Mailbox, "mailbox"},
+    {PresentModeOption::Fifo, "fifo"},
+    {PresentModeOption::FifoRelaxed, "fifo-relaxed"},
+};
+
+const char* getPresentModeName(PresentModeOption presentMode)
+{
+    for (const PresentModeName& entry : PRESENT_MODE_NAMES)
+    {
+        if (entry.presentMode == presentMode)
+        {
+            return entry.name;
+        }
+    }
+    return "default";
+}
+
+bool parsePresentMode(const std::string& name, PresentModeOption& presentMode)
+{
+    for (const PresentModeName& entry : PRESENT_MODE_NAMES)
+    {
+        if (name == entry.name)
+        {
+            presentMode = entry.presentMode;
+            return true;
+        }
+    }
+    return false;
+}
+
+#pragma endregion
+
+// Region: Recording
+// This section measures the startup and collects the frame times.
+#pragma region Recording
+
+void BenchmarkRecorder::start(uint32_t warmupFrames)
+{
+    startTime = std::chrono::steady_clock::now();
+    startupSeconds = 0.0;
+    warmupFrameCount = warmupFrames;
+    recordedFrames = 0;
+    frameTimes.clear();
+}
+
+void BenchmarkRecorder::markStartupComplete()
+{
+    startupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void BenchmarkRecorder::recordFrame(double seconds)
+{
+    if (recordedFrames++ >= warmupFrameCount)
+    {
+        frameTimes.push_back(seconds);
+    }
+}
+
+// Nearest-rank percentile of a sorted list: the smallest value with at least p% of the values at or below it.
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+FrameTimeSummary BenchmarkRecorder::summarize() const
+{
+    FrameTimeSummary summary;
+    summary.frameCount = static_cast<uint32_t>(frameTimes.size());
+    if (frameTimes.empty())
+    {
+        return summary;
+    }
+
+    std::vector<double> sorted(frameTimes);
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0.0;
+    for (double seconds : sorted)
+    {
+        total += seconds;
+    }
+
+    summary.mean = total * 1000.0 / sorted.size();
+    summary.p50 = percentile(sorted, 50.0) * 1000.0;
+    summary.p95 = percentile(sorted, 95.0) * 1000.0;
+    summary.p99 = percentile(sorted, 99.0) * 1000.0;
+    summary.min = sorted.front() * 1000.0;
+    summary.max = sorted.back() * 1000.0;
+    return summary;
+}
+
+#pragma endregion
+
+// Region: Report
+// This section writes the statistics as text or JSON.
+#pragma region Report
+
+void BenchmarkRecorder::writeReport(const char* project, const RunOptions& options, uint32_t width, uint32_t height, const char* presentMode) const
+{
+    FrameTimeSummary summary = summarize();
+    std::ostringstream report;
+    report.setf(std::ios::fixed);
+    report.precision(4);
+
+    if (options.reportFormat == ReportFormat::Json)
+    {
+        // One line: a JSON object per run, appended to the report file or alone on stdout.
+        report << "{\"project\":\"" << project << "\""
+               << ",\"headless\":" << (options.headless ? "true" : "false")
+               << ",\"width\":" << width << ",\"height\":" << height
+               << ",\"present_mode\":\"" << presentMode << "\""
+               << ",\"warmup_frames\":" << warmupFrameCount
+               << ",\"frames\":" << summary.frameCount
+               << ",\"startup_ms\":" << getStartupMilliseconds();
+        if (peakDeviceMemoryBytes > 0)
+        {
+            report << ",\"peak_device_memory_mib\":" << peakDeviceMemoryBytes / (1024.0 * 1024.0);
+        }
+        report << ",\"frame_time_ms\":{\"mean\":" << summary.mean << ",\"p50\":" << summary.p50 << ",\"p95\":" << summary.p95
+               << ",\"p99\":" << summary.p99 << ",\"min\":" << summary.min << ",\"max\":" << summary.max << "}}\n";
+    }
+    else
+    {
+        report << project << ": " << summary.frameCount << " frames measured after " << warmupFrameCount << " warmup, "
+               << width << "x" << height << ", present mode " << presentMode << (options.headless ? ", headless" : "") << "\n"
+               << "  startup    " << getStartupMilliseconds() << " ms\n"
+               << "  frame time mean " << summary.mean << " ms, p50 " << summary.p50 << " ms, p95 " << summary.p95 << " ms, p99 "
+               << summary.p99 << " ms (min " << summary.min << ", max " << summary.max << ")\n";
+        if (peakDeviceMemoryBytes > 0)
+        {
+            report << "  peak device memory " << peakDeviceMemoryBytes / (1024.0 * 1024.0) << " MiB\n";
+        }
+    }
+
+    if (options.reportFile.empty())
+    {
+        // The C stream, not std::cout: during a JSON run main() sends std::cout to stderr, so only the report reaches stdout.
+        fputs(report.str().c_str(), stdout);
+        fflush(stdout);
+        return;
+    }
+
+    std::ofstream file(options.reportFile, std::ios::app); // Append: nightly runs collect one line per run.
+    file << report.str();
+    if (!file)
+    {
+        throw std::runtime_error("failed to write benchmark report!");
+    }
+}
+
+#pragma endregion
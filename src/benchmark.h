@@ -0,0 +1,98 @@
+// benchmark.h
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>                   // For the startup clock
+#include <cstdint>                  // Necessary for uint32_t
+#include <string>                   // For file names and option values
+#include <vector>                   // For the recorded frame times
+
+// Present mode requested on the command line. Default keeps the project's own preference.
+enum class PresentModeOption
+{
+    Default,
+    Immediate,
+    Mailbox,
+    Fifo,
+    FifoRelaxed
+};
+
+// How the benchmark report is written at the end of a run.
+enum class ReportFormat
+{
+    Text,   // A few human-readable lines.
+    Json    // One JSON object on a single line, for scripts.
+};
+
+// Options of a run, shared by every project of the launcher. Zero sizes mean "the project's default".
+struct RunOptions
+{
+    bool headless = false;                                  // Render into offscreen images: no window, surface, swap chain or present queue.
+    uint32_t frameCount = 0;                                // Measured frames before exiting (0 = until the window closes; headless uses a default).
+    uint32_t warmupFrames = 0;                              // Frames rendered before the measurement starts (not part of the statistics).
+    uint32_t width = 0;                                     // Window / offscreen image width.
+    uint32_t height = 0;                                    // Window / offscreen image height.
+    PresentModeOption presentMode = PresentModeOption::Default; // Swap chain present mode (falls back to FIFO when unsupported).
+    ReportFormat reportFormat = ReportFormat::Text;         // Format of the report.
+    std::string reportFile;                                 // File the report is written to (empty = stdout).
+    std::string readbackFile;                               // Headless only: the last frame is written to this file as a binary PPM (empty = no readback).
+};
+
+// Command line spelling of a present mode ("default", "immediate", "mailbox", "fifo", "fifo-relaxed").
+const char* getPresentModeName(PresentModeOption presentMode);
+
+// Parses the command line spelling of a present mode. Returns false for an unknown name.
+bool parsePresentMode(const std::string& name, PresentModeOption& presentMode);
+
+// Statistics of the measured frames, in milliseconds.
+struct FrameTimeSummary
+{
+    uint32_t frameCount = 0;    // Frames measured (warmup excluded).
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+};
+
+// Collects the startup time and the frame times of one run and writes the report.
+// Every frame time is kept (8 bytes per frame), so the percentiles are exact.
+class BenchmarkRecorder
+{
+public:
+    // Starts the startup clock. The first warmupFrames recorded frames are not measured.
+    void start(uint32_t warmupFrames);
+
+    // Stops the startup clock: everything from start() to here (window, instance, device, resources) is startup.
+    void markStartupComplete();
+
+    // Records the duration of one frame, in seconds.
+    void recordFrame(double seconds);
+
+    // Frames recorded so far, warmup included.
+    uint32_t getRecordedFrameCount() const { return recordedFrames; }
+
+    double getStartupMilliseconds() const { return startupSeconds * 1000.0; }
+
+    // Highest device memory use of the run, added to the report (projects that do not track it leave it at 0 and
+    // the report omits it).
+    void setPeakDeviceMemory(uint64_t bytes) { peakDeviceMemoryBytes = bytes; }
+
+    // Mean, nearest-rank percentiles and extremes of the measured frames.
+    FrameTimeSummary summarize() const;
+
+    // Writes the report in options.reportFormat to options.reportFile (or stdout). presentMode is the mode
+    // actually used ("none" without a swap chain).
+    void writeReport(const char* project, const RunOptions& options, uint32_t width, uint32_t height, const char* presentMode) const;
+
+private:
+    std::chrono::steady_clock::time_point startTime;    // Set by start().
+    double startupSeconds = 0.0;                        // Set by markStartupComplete().
+    uint32_t warmupFrameCount = 0;                      // Frames to skip before measuring.
+    uint32_t recordedFrames = 0;                        // Frames recorded, warmup included.
+    uint64_t peakDeviceMemoryBytes = 0;                 // Set by setPeakDeviceMemory.
+    std::vector<double> frameTimes;                     // Measured frame times, in seconds.
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,223 @@
+// Region: Includes
+// This section includes the bindless descriptor set header and the standard headers it needs.
+#pragma region Includes
+
+// bindless_descriptors.cpp
+#include "bindless_descriptors.h"  // Include the header file for this module
+
+#include <algorithm>                // For std::min
+#include <array>                    // For the two bindings of the layout
+#include <stdexcept>                // For standard exception handling (e.g., std::runtime_error)
+
+#pragma endregion
+
+// Region: Device Support
+// This section checks the descriptor indexing features used by the set.
+#pragma region Device Support
+
+// The shaders index the arrays with dynamically uniform values (push constants), so no non-uniform indexing
+// feature is needed; only the binding flags and the runtime-sized arrays are.
+bool BindlessDescriptorSet::querySupport(VkPhysicalDevice physicalDevice, VkPhysicalDeviceDescriptorIndexingFeaturesEXT& enabledFeatures)
+{
+    enabledFeatures = {};
+    enabledFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+    // vkGetPhysicalDeviceFeatures2 is core in Vulkan 1.1.
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    if (properties.apiVersion < VK_API_VERSION_1_1)
+    {
+        return false;
+    }
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &indexingFeatures;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+    if (!indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind || !indexingFeatures.descriptorBindingSampledImageUpdateAfterBind ||
+        !indexingFeatures.descriptorBindingUpdateUnusedWhilePending || !indexingFeatures.descriptorBindingPartiallyBound ||
+        !indexingFeatures.runtimeDescriptorArray)
+    {
+        return false;
+    }
+
+    enabledFeatures.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    enabledFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    enabledFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    enabledFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+    enabledFeatures.runtimeDescriptorArray = VK_TRUE;
+    return true;
+}
+
+// Combined image samplers count both as sampled images and as samplers. Both arrays are visible to the fragment
+// stage, so together they must also fit maxPerStageUpdateAfterBindResources; the texture array gives way first.
+void BindlessDescriptorSet::clampToLimits(VkPhysicalDevice physicalDevice, uint32_t& maxBuffers, uint32_t& maxTextures)
+{
+    VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties{};
+    indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+    VkPhysicalDeviceProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &indexingProperties;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties); // Core in Vulkan 1.1, like the features query.
+
+    uint32_t resourceLimit = indexingProperties.maxPerStageUpdateAfterBindResources;
+    maxBuffers = std::min({maxBuffers, indexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                           indexingProperties.maxPerStageDescriptorUpdateAfterBindStorageBuffers, resourceLimit > 0 ? resourceLimit - 1 : 0});
+    maxTextures = std::min({maxTextures, indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+                            indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                            indexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+                            indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers, resourceLimit - maxBuffers});
+
+    if (maxBuffers == 0 || maxTextures == 0)
+    {
+        throw std::runtime_error("failed to create bindless descriptor set: update-after-bind descriptor limits are too low!");
+    }
+}
+
+#pragma endregion
+
+// Region: Lifetime
+// This section creates and destroys the layout, the pool and the set.
+#pragma region Lifetime
+
+void BindlessDescriptorSet::init(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, uint32_t maxBuffers, uint32_t maxTextures)
+{
+    clampToLimits(physicalDevice, maxBuffers, maxTextures);
+
+    device = logicalDevice;
+    bufferCapacity = maxBuffers;
+    textureCapacity = maxTextures;
+    bufferCount = 0;
+    textureCount = 0;
+
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding = BINDLESS_BUFFER_BINDING;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[0].descriptorCount = maxBuffers;
+    bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    bindings[1].binding = BINDLESS_TEXTURE_BINDING;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[1].descriptorCount = maxTextures;
+    bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    // Unwritten slots are allowed as long as no shader reads them, and slots may be written while the set is in use.
+    VkDescriptorBindingFlagsEXT bindingFlag = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT
+                                            | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT;
+    std::array<VkDescriptorBindingFlagsEXT, 2> bindingFlags = {bindingFlag, bindingFlag};
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo{};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+    bindingFlagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+    bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &bindingFlagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create bindless descriptor set layout!");
+    }
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[0].descriptorCount = maxBuffers;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[1].descriptorCount = maxTextures;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = 1;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create bindless descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &layout;
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, &set) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate bindless descriptor set!");
+    }
+}
+
+void BindlessDescriptorSet::cleanup()
+{
+    vkDestroyDescriptorPool(device, pool, nullptr); // Frees the set as well.
+    vkDestroyDescriptorSetLayout(device, layout, nullptr);
+    pool = VK_NULL_HANDLE;
+    layout = VK_NULL_HANDLE;
+    set = VK_NULL_HANDLE;
+}
+
+#pragma endregion
+
+// Region: Registration
+// This section writes resources into free slots of the arrays.
+#pragma region Registration
+
+uint32_t BindlessDescriptorSet::addBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+{
+    if (bufferCount == bufferCapacity)
+    {
+        throw std::runtime_error("bindless storage buffer array is full!");
+    }
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = buffer;
+    bufferInfo.offset = offset;
+    bufferInfo.range = range;
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = set;
+    descriptorWrite.dstBinding = BINDLESS_BUFFER_BINDING;
+    descriptorWrite.dstArrayElement = bufferCount;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+
+    return bufferCount++;
+}
+
+uint32_t BindlessDescriptorSet::addTexture(VkImageView imageView, VkSampler sampler, VkImageLayout imageLayout)
+{
+    if (textureCount == textureCapacity)
+    {
+        throw std::runtime_error("bindless texture array is full!");
+    }
+
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.sampler = sampler;
+    imageInfo.imageView = imageView;
+    imageInfo.imageLayout = imageLayout;
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = set;
+    descriptorWrite.dstBinding = BINDLESS_TEXTURE_BINDING;
+    descriptorWrite.dstArrayElement = textureCount;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+
+    return textureCount++;
+}
+
+#pragma endregion
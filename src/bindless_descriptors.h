@@ -0,0 +1,63 @@
+// bindless_descriptors.h
+#ifndef BINDLESS_DESCRIPTORS_H
+#define BINDLESS_DESCRIPTORS_H
+
+#include <vulkan/vulkan.h>          // Vulkan types (VkDescriptorSet, VkBuffer, ...)
+#include <cstdint>                  // Necessary for uint32_t
+
+const uint32_t BINDLESS_BUFFER_BINDING = 0;     // Binding of the storage buffer array.
+const uint32_t BINDLESS_TEXTURE_BINDING = 1;    // Binding of the combined image sampler array.
+
+// One large descriptor set holding every storage buffer and texture, for shaders that pick their resources with
+// indices (push constants or data) instead of per-draw descriptor sets.
+// Built on VK_EXT_descriptor_indexing: both arrays are partially bound and update-after-bind, so registering a
+// resource writes one unused slot and never invalidates command buffers that already bind the set, even while
+// they are pending. Slots are handed out in order and are never recycled.
+class BindlessDescriptorSet
+{
+public:
+    // Checks for the descriptor indexing features the set relies on, and fills enabledFeatures with them (to chain
+    // into VkDeviceCreateInfo::pNext) when they are all present. Needs a Vulkan 1.1 instance and device, and the
+    // device must also enable VK_EXT_descriptor_indexing and VK_KHR_maintenance3.
+    static bool querySupport(VkPhysicalDevice physicalDevice, VkPhysicalDeviceDescriptorIndexingFeaturesEXT& enabledFeatures);
+
+    // Creates the layout, an update-after-bind pool and the set with room for the given numbers of resources, clamped
+    // to the device's update-after-bind descriptor limits (getBufferCapacity / getTextureCapacity give the result).
+    // Throws if the limits leave no room for either array.
+    void init(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t maxBuffers, uint32_t maxTextures);
+
+    // Destroys the set, its pool and its layout. The registered resources are not owned.
+    void cleanup();
+
+    // Writes a storage buffer range into the next free slot and returns the slot index.
+    uint32_t addBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+    // Writes a sampled image into the next free texture slot and returns the slot index.
+    uint32_t addTexture(VkImageView imageView, VkSampler sampler, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    // Layout to place in a pipeline layout (as set 0 for the bindless shaders).
+    VkDescriptorSetLayout getLayout() const { return layout; }
+
+    // The set to bind once per command buffer.
+    VkDescriptorSet getSet() const { return set; }
+
+    uint32_t getBufferCount() const { return bufferCount; }
+    uint32_t getTextureCount() const { return textureCount; }
+    uint32_t getBufferCapacity() const { return bufferCapacity; }
+    uint32_t getTextureCapacity() const { return textureCapacity; }
+
+private:
+    // Lowers the requested array sizes to what VkPhysicalDeviceDescriptorIndexingProperties allows.
+    static void clampToLimits(VkPhysicalDevice physicalDevice, uint32_t& maxBuffers, uint32_t& maxTextures);
+
+    VkDevice device = VK_NULL_HANDLE;                   // Logical device.
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;      // Storage buffer array and texture array.
+    VkDescriptorPool pool = VK_NULL_HANDLE;             // Update-after-bind pool holding the single set.
+    VkDescriptorSet set = VK_NULL_HANDLE;               // The bindless set.
+    uint32_t bufferCapacity = 0;                        // Size of the storage buffer array.
+    uint32_t textureCapacity = 0;                       // Size of the texture array.
+    uint32_t bufferCount = 0;                           // Buffer slots written so far.
+    uint32_t textureCount = 0;                          // Texture slots written so far.
+};
+
+#endif // BINDLESS_DESCRIPTORS_H
@@ -0,0 +1,118 @@
+// Region: Includes
+// This section includes the CPU profiler header and the standard headers it needs.
+#pragma region Includes
+
+// cpu_profiler.cpp
+#include "cpu_profiler.h"           // Include the header file for this module
+
+#ifdef ENABLE_CPU_PROFILER
+    #include <chrono>               // For the steady clock the zones are timed with
+    #include <cstdio>               // For writing the trace with fprintf
+    #include <memory>               // For std::unique_ptr owning the thread buffers
+    #include <mutex>                // For guarding the buffer registry
+    #include <vector>               // For the buffer registry
+#endif
+
+#pragma endregion
+
+// Without ENABLE_CPU_PROFILER this translation unit is empty.
+#ifdef ENABLE_CPU_PROFILER
+
+// Region: Thread Buffers
+// This section hands each thread its own event buffer.
+#pragma region Thread Buffers
+
+// Buffers are owned by the registry, not by their threads, so the zones of finished threads stay exportable.
+static std::mutex registryMutex;
+static std::vector<std::unique_ptr<CpuProfileThreadBuffer>> registry;
+
+uint64_t CpuProfiler::now()
+{
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+CpuProfileThreadBuffer& CpuProfiler::getThreadBuffer()
+{
+    thread_local CpuProfileThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(std::make_unique<CpuProfileThreadBuffer>());
+        buffer = registry.back().get();
+        buffer->threadIndex = static_cast<uint32_t>(registry.size());
+    }
+    return *buffer;
+}
+
+void CpuProfiler::record(const char* name, uint64_t startNanoseconds, uint64_t endNanoseconds)
+{
+    CpuProfileThreadBuffer& buffer = getThreadBuffer();
+    uint32_t index = buffer.count.load(std::memory_order_relaxed); // Only this thread writes count.
+    if (index == CPU_PROFILER_EVENTS_PER_THREAD)
+    {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    CpuProfileEvent& event = buffer.events[index];
+    event.name = name;
+    event.startNanoseconds = startNanoseconds;
+    event.durationNanoseconds = endNanoseconds - startNanoseconds;
+    buffer.count.store(index + 1, std::memory_order_release); // Publish the entry to the exporter.
+}
+
+void CpuProfiler::setThreadName(const char* name)
+{
+    getThreadBuffer().threadName.store(name, std::memory_order_relaxed);
+}
+
+#pragma endregion
+
+// Region: Export
+// This section writes the recorded zones as Chrome trace events.
+#pragma region Export
+
+// Every zone becomes a complete event ("ph":"X") with microsecond timestamps; named threads also get a
+// thread_name metadata event. Zones still open (or recorded while exporting) are left out.
+bool CpuProfiler::writeChromeTrace(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex); // Keeps the registry stable; the threads keep recording.
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+    uint32_t dropped = 0;
+    for (const auto& buffer : registry)
+    {
+        const char* threadName = buffer->threadName.load(std::memory_order_relaxed);
+        if (threadName != nullptr)
+        {
+            fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", first ? "" : ",", buffer->threadIndex, threadName);
+            first = false;
+        }
+
+        uint32_t count = buffer->count.load(std::memory_order_acquire); // Entries below count are complete.
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const CpuProfileEvent& event = buffer->events[i];
+            fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", first ? "" : ",", event.name, buffer->threadIndex,
+                    event.startNanoseconds / 1000.0, event.durationNanoseconds / 1000.0);
+            first = false;
+        }
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    fprintf(file, "\n],\"otherData\":{\"droppedZones\":%u}}\n", dropped);
+
+    bool written = ferror(file) == 0;
+    fclose(file);
+    return written;
+}
+
+#pragma endregion
+
+#endif // ENABLE_CPU_PROFILER
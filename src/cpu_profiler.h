@@ -0,0 +1,91 @@
+// cpu_profiler.h
+#ifndef CPU_PROFILER_H
+#define CPU_PROFILER_H
+
+// Scoped CPU zone profiler with Chrome trace export.
+// Compiled in with ENABLE_CPU_PROFILER (CMake option ENABLE_CPU_PROFILER, or make CPU_PROFILER=1). Without it the
+// PROFILE_* macros expand to nothing and this header declares nothing else, so instrumented code pays no cost.
+//
+//   PROFILE_ZONE("name");              Times the enclosing scope. The name must be a string literal.
+//   PROFILE_FUNCTION();                Same, named after the enclosing function.
+//   PROFILE_THREAD_NAME("name");       Names the calling thread in the trace.
+//   PROFILE_WRITE_TRACE("file.json");  Writes every zone recorded so far as Chrome trace-event JSON
+//                                      (chrome://tracing or ui.perfetto.dev).
+
+#ifdef ENABLE_CPU_PROFILER
+
+#include <atomic>                   // For the published event count of each thread buffer
+#include <cstdint>                  // Necessary for uint64_t / uint32_t
+#include <string>                   // For the trace file name
+
+const uint32_t CPU_PROFILER_EVENTS_PER_THREAD = 1 << 16; // Zones kept per thread; later zones are counted as dropped.
+
+// One finished zone.
+struct CpuProfileEvent
+{
+    const char* name;               // String literal or __func__ (never copied).
+    uint64_t startNanoseconds;      // Since the profiler epoch.
+    uint64_t durationNanoseconds;
+};
+
+// Events of one thread. Only the owning thread writes; it fills an entry, then publishes it by incrementing count
+// with release order, so the exporter reads complete entries without any lock.
+struct CpuProfileThreadBuffer
+{
+    CpuProfileEvent events[CPU_PROFILER_EVENTS_PER_THREAD];
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> dropped{0};
+    std::atomic<const char*> threadName{nullptr};
+    uint32_t threadIndex = 0;       // Trace "tid" (registration order).
+};
+
+class CpuProfiler
+{
+public:
+    // Nanoseconds since the first call (the epoch of the trace).
+    static uint64_t now();
+
+    // Buffer of the calling thread. Registered under a mutex on the thread's first zone only.
+    static CpuProfileThreadBuffer& getThreadBuffer();
+
+    // Appends a finished zone to the calling thread's buffer.
+    static void record(const char* name, uint64_t startNanoseconds, uint64_t endNanoseconds);
+
+    static void setThreadName(const char* name);
+
+    // Writes the zones of every thread as Chrome trace-event JSON. Returns false if the file cannot be written.
+    static bool writeChromeTrace(const std::string& path);
+};
+
+// RAII zone: measures from construction to destruction.
+class CpuProfileZone
+{
+public:
+    explicit CpuProfileZone(const char* zoneName) : name(zoneName), start(CpuProfiler::now()) {}
+    ~CpuProfileZone() { CpuProfiler::record(name, start, CpuProfiler::now()); }
+
+    CpuProfileZone(const CpuProfileZone&) = delete;
+    CpuProfileZone& operator=(const CpuProfileZone&) = delete;
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) CpuProfileZone PROFILE_CONCAT(cpuProfileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+#define PROFILE_THREAD_NAME(name) CpuProfiler::setThreadName(name)
+#define PROFILE_WRITE_TRACE(path) CpuProfiler::writeChromeTrace(path)
+
+#else
+
+#define PROFILE_ZONE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_THREAD_NAME(name)
+#define PROFILE_WRITE_TRACE(path)
+
+#endif // ENABLE_CPU_PROFILER
+
+#endif // CPU_PROFILER_H
@@ -0,0 +1,184 @@
+// Region: Includes
+// This section includes the frame statistics header and the standard headers it needs.
+#pragma region Includes
+
+// frame_stats.cpp
+#include "frame_stats.h"            // Include the header file for this module
+#include "cpu_profiler.h"           // Include the scoped CPU zones (compiled out without ENABLE_CPU_PROFILER)
+
+#include <algorithm>                // For std::nth_element / std::min / std::max
+
+#pragma endregion
+
+// Region: Ring
+// This section implements the lock-free single-producer single-consumer sample ring.
+#pragma region Ring
+
+static_assert((FRAME_STATS_RING_SIZE & (FRAME_STATS_RING_SIZE - 1)) == 0, "FRAME_STATS_RING_SIZE must be a power of two");
+
+// The indices run freely and wrap around; head - tail is the number of queued samples even after they overflow.
+bool FrameStatsRing::push(const FrameStatsSample& sample)
+{
+    uint32_t writeIndex = head.load(std::memory_order_relaxed); // Only the producer writes head.
+    if (writeIndex - tail.load(std::memory_order_acquire) == FRAME_STATS_RING_SIZE)
+    {
+        return false; // Full: the consumer has not freed a slot yet.
+    }
+    samples[writeIndex & (FRAME_STATS_RING_SIZE - 1)] = sample;
+    head.store(writeIndex + 1, std::memory_order_release); // Publish the sample to the consumer.
+    return true;
+}
+
+bool FrameStatsRing::pop(FrameStatsSample& sample)
+{
+    uint32_t readIndex = tail.load(std::memory_order_relaxed); // Only the consumer writes tail.
+    if (readIndex == head.load(std::memory_order_acquire))
+    {
+        return false; // Empty.
+    }
+    sample = samples[readIndex & (FRAME_STATS_RING_SIZE - 1)];
+    tail.store(readIndex + 1, std::memory_order_release); // Hand the slot back to the producer.
+    return true;
+}
+
+#pragma endregion
+
+// Region: Collector
+// This section runs the reader thread and publishes the snapshots.
+#pragma region Collector
+
+// Stops the reader if the owner forgot to call stop().
+FrameStatsCollector::~FrameStatsCollector()
+{
+    stop();
+}
+
+void FrameStatsCollector::start(std::chrono::milliseconds interval)
+{
+    readerInterval = interval;
+    stopping = false;
+    reader = std::thread(&FrameStatsCollector::readerLoop, this);
+}
+
+void FrameStatsCollector::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+
+    if (reader.joinable())
+    {
+        reader.join();
+    }
+}
+
+void FrameStatsCollector::push(const FrameStatsSample& sample)
+{
+    if (!ring.push(sample))
+    {
+        droppedSamples.fetch_add(1, std::memory_order_relaxed); // The reader fell FRAME_STATS_RING_SIZE frames behind.
+    }
+}
+
+bool FrameStatsCollector::tryGetSnapshot(FrameStatsSnapshot& snapshot)
+{
+    std::unique_lock<std::mutex> lock(snapshotMutex, std::try_to_lock);
+    if (!lock.owns_lock() || !hasSnapshot)
+    {
+        return false;
+    }
+    snapshot = published;
+    return true;
+}
+
+const char* FrameStatsCollector::getMetricName(FrameMetric metric)
+{
+    switch (metric)
+    {
+    case FrameMetric::Cpu:
+        return "cpu";
+    case FrameMetric::Gpu:
+        return "gpu";
+    case FrameMetric::FenceWait:
+        return "fence wait";
+    case FrameMetric::PresentLatency:
+        return "present latency";
+    default:
+        return "unknown";
+    }
+}
+
+// Sleeps for the interval (or until stopped), then drains the ring and summarizes if new frames arrived.
+void FrameStatsCollector::readerLoop()
+{
+    PROFILE_THREAD_NAME("frame stats");
+    std::unique_lock<std::mutex> lock(stopMutex);
+    while (!wakeUp.wait_for(lock, readerInterval, [this]() { return stopping; }))
+    {
+        bool received = false;
+        FrameStatsSample sample;
+        while (ring.pop(sample))
+        {
+            for (uint32_t metric = 0; metric < FRAME_METRIC_COUNT; metric++)
+            {
+                window[metric][windowNext] = sample.milliseconds[metric];
+            }
+            windowNext = (windowNext + 1) % FRAME_STATS_WINDOW;
+            windowCount = std::min(windowCount + 1, FRAME_STATS_WINDOW);
+            received = true;
+        }
+
+        if (received)
+        {
+            summarize();
+        }
+    }
+}
+
+#pragma endregion
+
+// Region: Statistics
+// This section computes the histograms and percentiles of the rolling window.
+#pragma region Statistics
+
+// Builds the snapshot outside the lock, so the render thread only ever finds the mutex held for the copy.
+void FrameStatsCollector::summarize()
+{
+    PROFILE_FUNCTION();
+    FrameStatsSnapshot snapshot;
+    snapshot.sampleCount = windowCount;
+    snapshot.droppedSamples = droppedSamples.load(std::memory_order_relaxed);
+
+    for (uint32_t metric = 0; metric < FRAME_METRIC_COUNT; metric++)
+    {
+        FrameMetricSummary& summary = snapshot.metrics[metric];
+        double total = 0.0;
+        for (uint32_t i = 0; i < windowCount; i++)
+        {
+            float value = window[metric][i];
+            total += value;
+            summary.max = std::max(summary.max, value);
+            uint32_t bin = static_cast<uint32_t>(std::max(value, 0.0f) / FRAME_STATS_BIN_MILLISECONDS);
+            summary.bins[std::min(bin, FRAME_STATS_BINS - 1)]++;
+            sorted[i] = value;
+        }
+        summary.mean = static_cast<float>(total / windowCount);
+
+        // Nearest-rank percentiles; nth_element leaves everything below the rank in front of it, so the second
+        // selection only searches the upper part.
+        uint32_t p50Rank = (windowCount - 1) / 2;
+        uint32_t p99Rank = (windowCount * 99 + 99) / 100 - 1;
+        std::nth_element(sorted, sorted + p50Rank, sorted + windowCount);
+        summary.p50 = sorted[p50Rank];
+        std::nth_element(sorted + p50Rank, sorted + p99Rank, sorted + windowCount);
+        summary.p99 = sorted[p99Rank];
+    }
+
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    published = snapshot;
+    hasSnapshot = true;
+}
+
+#pragma endregion
@@ -0,0 +1,114 @@
+// frame_stats.h
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <atomic>                   // For the head / tail indices of the ring
+#include <chrono>                   // For the reader interval
+#include <condition_variable>       // For waking the reader thread when it stops
+#include <cstdint>                  // Necessary for uint32_t / uint64_t
+#include <mutex>                    // For guarding the published snapshot
+#include <thread>                   // For the reader thread
+
+// Per-frame measurements, in milliseconds.
+enum class FrameMetric : uint32_t
+{
+    Cpu,                            // Frame loop iteration, minus the fence wait.
+    Gpu,                            // Sum of the GPU profiler passes of the frame.
+    FenceWait,                      // Time blocked on the fence of the frame slot.
+    PresentLatency,                 // Start of the frame on the CPU until its fence is seen signaled.
+    Count
+};
+const uint32_t FRAME_METRIC_COUNT = static_cast<uint32_t>(FrameMetric::Count);
+
+const uint32_t FRAME_STATS_RING_SIZE = 1024;        // Samples the ring holds (a power of two); later ones are dropped.
+const uint32_t FRAME_STATS_WINDOW = 256;            // Frames the rolling statistics cover.
+const uint32_t FRAME_STATS_BINS = 32;               // Histogram bins per metric.
+const float FRAME_STATS_BIN_MILLISECONDS = 1.0f;    // Width of a bin; the last one also counts every longer frame.
+
+struct FrameStatsSample
+{
+    float milliseconds[FRAME_METRIC_COUNT] = {};
+};
+
+// Single-producer single-consumer ring of samples. The render thread pushes and the reader thread pops; each index is
+// written by one side only and published with release order, so neither side ever takes a lock or waits.
+class FrameStatsRing
+{
+public:
+    // Producer side. Returns false (and drops the sample) when the ring is full.
+    bool push(const FrameStatsSample& sample);
+
+    // Consumer side. Returns false when the ring is empty.
+    bool pop(FrameStatsSample& sample);
+
+private:
+    FrameStatsSample samples[FRAME_STATS_RING_SIZE];
+    alignas(64) std::atomic<uint32_t> head{0};      // Next slot written by the producer (free-running counter).
+    alignas(64) std::atomic<uint32_t> tail{0};      // Next slot read by the consumer (own cache line: no false sharing).
+};
+
+// Rolling statistics of one metric over the last FRAME_STATS_WINDOW frames.
+struct FrameMetricSummary
+{
+    float mean = 0.0f;
+    float p50 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+    uint32_t bins[FRAME_STATS_BINS] = {};           // Frames per FRAME_STATS_BIN_MILLISECONDS wide bin.
+};
+
+struct FrameStatsSnapshot
+{
+    FrameMetricSummary metrics[FRAME_METRIC_COUNT];
+    uint32_t sampleCount = 0;                       // Frames in the window.
+    uint64_t droppedSamples = 0;                    // Samples lost to a full ring since start.
+};
+
+// Collects frame samples on a reader thread. push() only touches the ring; every interval the reader drains it into
+// the rolling window, recomputes the histograms and percentiles and publishes a snapshot under a mutex, which the
+// render thread reads with try_lock so it never waits for the reader.
+class FrameStatsCollector
+{
+public:
+    ~FrameStatsCollector(); // Stops the reader if stop() was not called.
+
+    // Starts the reader thread, summarizing every interval.
+    void start(std::chrono::milliseconds interval = std::chrono::milliseconds(100));
+
+    // Joins the reader thread.
+    void stop();
+
+    // Render thread: queues the sample of a frame. Never blocks.
+    void push(const FrameStatsSample& sample);
+
+    // Copies the latest snapshot. Returns false (leaving snapshot untouched) if there is none yet or the reader is
+    // publishing one right now.
+    bool tryGetSnapshot(FrameStatsSnapshot& snapshot);
+
+    static const char* getMetricName(FrameMetric metric);
+
+private:
+    void readerLoop();
+    void summarize();
+
+    FrameStatsRing ring;
+    std::atomic<uint64_t> droppedSamples{0};
+
+    // Reader thread only.
+    float window[FRAME_METRIC_COUNT][FRAME_STATS_WINDOW] = {};  // Ring of the last samples of each metric.
+    float sorted[FRAME_STATS_WINDOW] = {};                      // Scratch for the percentiles.
+    uint32_t windowCount = 0;                                   // Valid entries of window.
+    uint32_t windowNext = 0;                                    // Entry overwritten by the next sample.
+
+    std::thread reader;
+    std::chrono::milliseconds readerInterval{100};
+    std::mutex stopMutex;                                       // Guards stopping.
+    std::condition_variable wakeUp;                             // Signaled when the reader must stop.
+    bool stopping = false;
+
+    std::mutex snapshotMutex;                                   // Guards published and hasSnapshot.
+    FrameStatsSnapshot published;
+    bool hasSnapshot = false;
+};
+
+#endif // FRAME_STATS_H
@@ -0,0 +1,354 @@
+// Region: Includes
+// This section includes the frustum culler header and the SIMD intrinsics it uses.
+#pragma region Includes
+
+// frustum_culler.cpp
+#include "frustum_culler.h"        // Include the header file for this module
+
+#include <cmath>                    // For std::sqrt / std::fabs
+#include <limits>                   // For the quiet NaN of the padding objects
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define FRUSTUM_CULLER_X86
+    #include <immintrin.h>          // SSE / AVX intrinsics
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>         // For __cpuid
+    #endif
+#endif
+
+// GCC and Clang only emit AVX instructions in functions compiled for it; the rest of the program stays baseline
+// x86-64, and the AVX path is only called after the runtime check. MSVC accepts the intrinsics anywhere.
+#if defined(__GNUC__) || defined(__clang__)
+    #define FRUSTUM_CULLER_AVX_TARGET __attribute__((target("avx")))
+#else
+    #define FRUSTUM_CULLER_AVX_TARGET
+#endif
+
+#pragma endregion
+
+// Region: Frustum
+// This section extracts the frustum planes and checks which instruction set is available.
+#pragma region Frustum
+
+const size_t CULL_BATCH_SIZE = 8; // Objects per AVX register; the arrays are padded to a multiple of it.
+
+// Six planes (a, b, c, d) with a*x + b*y + c*z + d >= 0 inside and (a, b, c) normalized, so d is a distance.
+struct FrustumPlanes
+{
+    float planes[6][4];
+};
+
+// Gribb-Hartmann extraction: each plane is a sum or difference of rows of the matrix. Vulkan clip space keeps
+// -w <= x, y <= w and 0 <= z <= w, so the near plane is row 2 alone.
+static FrustumPlanes extractPlanes(const float m[16])
+{
+    auto row = [&](int r, int c) { return m[c * 4 + r]; }; // Column major.
+
+    FrustumPlanes frustum;
+    for (int c = 0; c < 4; c++)
+    {
+        frustum.planes[0][c] = row(3, c) + row(0, c); // Left
+        frustum.planes[1][c] = row(3, c) - row(0, c); // Right
+        frustum.planes[2][c] = row(3, c) + row(1, c); // Bottom
+        frustum.planes[3][c] = row(3, c) - row(1, c); // Top
+        frustum.planes[4][c] = row(2, c);             // Near
+        frustum.planes[5][c] = row(3, c) - row(2, c); // Far
+    }
+    for (auto& plane : frustum.planes)
+    {
+        float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        for (int c = 0; c < 4; c++)
+        {
+            plane[c] /= length;
+        }
+    }
+    return frustum;
+}
+
+// True if the CPU and the OS support AVX (the OS must save the YMM registers).
+static bool detectAvx()
+{
+#if defined(FRUSTUM_CULLER_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx");
+#elif defined(FRUSTUM_CULLER_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osUsesXsave = (info[2] & (1 << 27)) != 0;
+    bool cpuHasAvx = (info[2] & (1 << 28)) != 0;
+    return osUsesXsave && cpuHasAvx && (_xgetbv(0) & 6) == 6;
+#else
+    return false;
+#endif
+}
+
+static bool hasAvx()
+{
+    static const bool supported = detectAvx();
+    return supported;
+}
+
+// Appends base + lane for every set bit of the mask without branching: every lane is written, but the count
+// only advances for visible ones. visible has room for the whole padded array, so the stores stay in bounds.
+static inline size_t appendVisible(int mask, size_t base, int lanes, uint32_t* visible, size_t count)
+{
+    for (int lane = 0; lane < lanes; lane++)
+    {
+        visible[count] = static_cast<uint32_t>(base + lane);
+        count += (mask >> lane) & 1;
+    }
+    return count;
+}
+
+#pragma endregion
+
+// Region: Kernels
+// This section tests the bounds against the planes, 8 (AVX), 4 (SSE) or 1 (scalar) objects at a time.
+// An object is visible if no plane has it entirely on the outside: distance > -radius for every plane.
+#pragma region Kernels
+
+#ifdef FRUSTUM_CULLER_X86
+
+FRUSTUM_CULLER_AVX_TARGET
+static size_t cullSpheresAvx(const FrustumPlanes& frustum, const float* x, const float* y, const float* z, const float* radius, size_t paddedCount, uint32_t* visible)
+{
+    __m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+    for (int p = 0; p < 6; p++)
+    {
+        planeX[p] = _mm256_set1_ps(frustum.planes[p][0]);
+        planeY[p] = _mm256_set1_ps(frustum.planes[p][1]);
+        planeZ[p] = _mm256_set1_ps(frustum.planes[p][2]);
+        planeW[p] = _mm256_set1_ps(frustum.planes[p][3]);
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < paddedCount; i += 8)
+    {
+        __m256 centerX = _mm256_loadu_ps(x + i);
+        __m256 centerY = _mm256_loadu_ps(y + i);
+        __m256 centerZ = _mm256_loadu_ps(z + i);
+        __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radius + i));
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; p++)
+        {
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[p], centerX), _mm256_mul_ps(planeY[p], centerY)),
+                                            _mm256_add_ps(_mm256_mul_ps(planeZ[p], centerZ), planeW[p]));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GT_OQ)); // NaN padding compares false.
+        }
+        count = appendVisible(_mm256_movemask_ps(inside), i, 8, visible, count);
+    }
+    return count;
+}
+
+FRUSTUM_CULLER_AVX_TARGET
+static size_t cullBoxesAvx(const FrustumPlanes& frustum, const float* x, const float* y, const float* z, const float* ex, const float* ey, const float* ez, size_t paddedCount, uint32_t* visible)
+{
+    __m256 planeX[6], planeY[6], planeZ[6], planeW[6], absX[6], absY[6], absZ[6];
+    for (int p = 0; p < 6; p++)
+    {
+        planeX[p] = _mm256_set1_ps(frustum.planes[p][0]);
+        planeY[p] = _mm256_set1_ps(frustum.planes[p][1]);
+        planeZ[p] = _mm256_set1_ps(frustum.planes[p][2]);
+        planeW[p] = _mm256_set1_ps(frustum.planes[p][3]);
+        absX[p] = _mm256_set1_ps(std::fabs(frustum.planes[p][0]));
+        absY[p] = _mm256_set1_ps(std::fabs(frustum.planes[p][1]));
+        absZ[p] = _mm256_set1_ps(std::fabs(frustum.planes[p][2]));
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < paddedCount; i += 8)
+    {
+        __m256 centerX = _mm256_loadu_ps(x + i);
+        __m256 centerY = _mm256_loadu_ps(y + i);
+        __m256 centerZ = _mm256_loadu_ps(z + i);
+        __m256 extentX = _mm256_loadu_ps(ex + i);
+        __m256 extentY = _mm256_loadu_ps(ey + i);
+        __m256 extentZ = _mm256_loadu_ps(ez + i);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; p++)
+        {
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[p], centerX), _mm256_mul_ps(planeY[p], centerY)),
+                                            _mm256_add_ps(_mm256_mul_ps(planeZ[p], centerZ), planeW[p]));
+            __m256 projectedExtent = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(absX[p], extentX), _mm256_mul_ps(absY[p], extentY)),
+                                                   _mm256_mul_ps(absZ[p], extentZ));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_sub_ps(_mm256_setzero_ps(), projectedExtent), _CMP_GT_OQ));
+        }
+        count = appendVisible(_mm256_movemask_ps(inside), i, 8, visible, count);
+    }
+    return count;
+}
+
+static size_t cullSpheresSse(const FrustumPlanes& frustum, const float* x, const float* y, const float* z, const float* radius, size_t paddedCount, uint32_t* visible)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < paddedCount; i += 4)
+    {
+        __m128 centerX = _mm_loadu_ps(x + i);
+        __m128 centerY = _mm_loadu_ps(y + i);
+        __m128 centerZ = _mm_loadu_ps(z + i);
+        __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; p++)
+        {
+            const float* plane = frustum.planes[p];
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), centerX), _mm_mul_ps(_mm_set1_ps(plane[1]), centerY)),
+                                         _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[2]), centerZ), _mm_set1_ps(plane[3])));
+            inside = _mm_and_ps(inside, _mm_cmpgt_ps(distance, negativeRadius));
+        }
+        count = appendVisible(_mm_movemask_ps(inside), i, 4, visible, count);
+    }
+    return count;
+}
+
+static size_t cullBoxesSse(const FrustumPlanes& frustum, const float* x, const float* y, const float* z, const float* ex, const float* ey, const float* ez, size_t paddedCount, uint32_t* visible)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < paddedCount; i += 4)
+    {
+        __m128 centerX = _mm_loadu_ps(x + i);
+        __m128 centerY = _mm_loadu_ps(y + i);
+        __m128 centerZ = _mm_loadu_ps(z + i);
+        __m128 extentX = _mm_loadu_ps(ex + i);
+        __m128 extentY = _mm_loadu_ps(ey + i);
+        __m128 extentZ = _mm_loadu_ps(ez + i);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; p++)
+        {
+            const float* plane = frustum.planes[p];
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), centerX), _mm_mul_ps(_mm_set1_ps(plane[1]), centerY)),
+                                         _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[2]), centerZ), _mm_set1_ps(plane[3])));
+            __m128 projectedExtent = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::fabs(plane[0])), extentX), _mm_mul_ps(_mm_set1_ps(std::fabs(plane[1])), extentY)),
+                                                _mm_mul_ps(_mm_set1_ps(std::fabs(plane[2])), extentZ));
+            inside = _mm_and_ps(inside, _mm_cmpgt_ps(distance, _mm_sub_ps(_mm_setzero_ps(), projectedExtent)));
+        }
+        count = appendVisible(_mm_movemask_ps(inside), i, 4, visible, count);
+    }
+    return count;
+}
+
+#else
+
+// Portable path for other architectures.
+static size_t cullScalar(const FrustumPlanes& frustum, BoundsShape shape, const float* x, const float* y, const float* z, const float* radius,
+                         const float* ex, const float* ey, const float* ez, size_t paddedCount, uint32_t* visible)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < paddedCount; i++)
+    {
+        int inside = 1;
+        for (int p = 0; p < 6; p++)
+        {
+            const float* plane = frustum.planes[p];
+            float distance = plane[0] * x[i] + plane[1] * y[i] + plane[2] * z[i] + plane[3];
+            float extent = shape == BoundsShape::Sphere ? radius[i]
+                         : std::fabs(plane[0]) * ex[i] + std::fabs(plane[1]) * ey[i] + std::fabs(plane[2]) * ez[i];
+            inside &= distance > -extent ? 1 : 0;
+        }
+        count = appendVisible(inside, i, 1, visible, count);
+    }
+    return count;
+}
+
+#endif
+
+#pragma endregion
+
+// Region: Public Interface
+// This section manages the bounds arrays and dispatches to the fastest kernel.
+#pragma region Public Interface
+
+void FrustumCuller::clear()
+{
+    objectCount = 0;
+    for (auto* array : {&sphereX, &sphereY, &sphereZ, &sphereRadius, &boxX, &boxY, &boxZ, &extentX, &extentY, &extentZ})
+    {
+        array->clear();
+    }
+}
+
+// Appends a batch of padding objects: NaN centers fail every comparison, so they are never reported.
+void FrustumCuller::grow()
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    size_t size = sphereX.size() + CULL_BATCH_SIZE;
+    for (auto* array : {&sphereX, &sphereY, &sphereZ, &boxX, &boxY, &boxZ})
+    {
+        array->resize(size, nan);
+    }
+    for (auto* array : {&sphereRadius, &extentX, &extentY, &extentZ})
+    {
+        array->resize(size, 0.0f);
+    }
+}
+
+uint32_t FrustumCuller::addObject(const float center[3], float radius, const float boxMin[3], const float boxMax[3])
+{
+    if (objectCount == sphereX.size())
+    {
+        grow();
+    }
+    uint32_t index = static_cast<uint32_t>(objectCount++);
+    setObject(index, center, radius, boxMin, boxMax);
+    return index;
+}
+
+// Boxes are stored as center and half size, which turns the box test into a single distance comparison per plane.
+void FrustumCuller::setObject(uint32_t index, const float center[3], float radius, const float boxMin[3], const float boxMax[3])
+{
+    sphereX[index] = center[0];
+    sphereY[index] = center[1];
+    sphereZ[index] = center[2];
+    sphereRadius[index] = radius;
+    boxX[index] = (boxMin[0] + boxMax[0]) * 0.5f;
+    boxY[index] = (boxMin[1] + boxMax[1]) * 0.5f;
+    boxZ[index] = (boxMin[2] + boxMax[2]) * 0.5f;
+    extentX[index] = (boxMax[0] - boxMin[0]) * 0.5f;
+    extentY[index] = (boxMax[1] - boxMin[1]) * 0.5f;
+    extentZ[index] = (boxMax[2] - boxMin[2]) * 0.5f;
+}
+
+size_t FrustumCuller::cull(const float viewProjection[16], BoundsShape shape, std::vector<uint32_t>& visible) const
+{
+    size_t paddedCount = sphereX.size();
+    if (visible.size() < paddedCount)
+    {
+        visible.resize(paddedCount);
+    }
+    if (paddedCount == 0)
+    {
+        return 0;
+    }
+
+    FrustumPlanes frustum = extractPlanes(viewProjection);
+    uint32_t* output = visible.data();
+#ifdef FRUSTUM_CULLER_X86
+    if (hasAvx())
+    {
+        return shape == BoundsShape::Sphere
+            ? cullSpheresAvx(frustum, sphereX.data(), sphereY.data(), sphereZ.data(), sphereRadius.data(), paddedCount, output)
+            : cullBoxesAvx(frustum, boxX.data(), boxY.data(), boxZ.data(), extentX.data(), extentY.data(), extentZ.data(), paddedCount, output);
+    }
+    return shape == BoundsShape::Sphere
+        ? cullSpheresSse(frustum, sphereX.data(), sphereY.data(), sphereZ.data(), sphereRadius.data(), paddedCount, output)
+        : cullBoxesSse(frustum, boxX.data(), boxY.data(), boxZ.data(), extentX.data(), extentY.data(), extentZ.data(), paddedCount, output);
+#else
+    const bool sphere = shape == BoundsShape::Sphere;
+    return cullScalar(frustum, shape, sphere ? sphereX.data() : boxX.data(), sphere ? sphereY.data() : boxY.data(), sphere ? sphereZ.data() : boxZ.data(),
+                      sphereRadius.data(), extentX.data(), extentY.data(), extentZ.data(), paddedCount, output);
+#endif
+}
+
+const char* FrustumCuller::getInstructionSetName()
+{
+#ifdef FRUSTUM_CULLER_X86
+    return hasAvx() ? "AVX" : "SSE";
+#else
+    return "scalar";
+#endif
+}
+
+#pragma endregion
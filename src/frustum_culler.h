@@ -0,0 +1,51 @@
+// frustum_culler.h
+#ifndef FRUSTUM_CULLER_H
+#define FRUSTUM_CULLER_H
+
+#include <cstddef>                  // Necessary for size_t
+#include <cstdint>                  // Necessary for uint32_t
+#include <vector>                   // For using std::vector dynamic arrays
+
+// Bounding volume tested by FrustumCuller::cull.
+enum class BoundsShape
+{
+    Sphere,                         // Center and radius: one multiply-add chain per plane.
+    Box                             // Axis-aligned box: also projects the extents onto each plane normal.
+};
+
+// Frustum culling of many objects at once.
+// The bounds are stored as structure-of-arrays (one array per component), so a single SIMD instruction tests the
+// same plane against 8 objects (AVX) or 4 objects (SSE). The arrays are padded to a multiple of 8 with objects
+// that are never visible, so the loops have no remainder. Uses AVX when the CPU supports it at runtime.
+class FrustumCuller
+{
+public:
+    // Removes every object.
+    void clear();
+
+    // Adds an object with both bounding volumes and returns its index (the value written to the visible list).
+    uint32_t addObject(const float center[3], float radius, const float boxMin[3], const float boxMax[3]);
+
+    // Replaces the bounds of an object (for objects that move).
+    void setObject(uint32_t index, const float center[3], float radius, const float boxMin[3], const float boxMax[3]);
+
+    size_t getObjectCount() const { return objectCount; }
+
+    // Extracts the six planes of viewProjection (column major, Vulkan clip space with depth in [0, 1]) and writes
+    // the indices of the objects that intersect the frustum to the front of visible, in increasing order.
+    // visible is grown to the padded object count when needed and never shrunk; returns the number written.
+    size_t cull(const float viewProjection[16], BoundsShape shape, std::vector<uint32_t>& visible) const;
+
+    // Name of the code path cull() uses on this CPU.
+    static const char* getInstructionSetName();
+
+private:
+    void grow();
+
+    size_t objectCount = 0;
+    std::vector<float> sphereX, sphereY, sphereZ, sphereRadius;     // Bounding spheres.
+    std::vector<float> boxX, boxY, boxZ;                            // Box centers.
+    std::vector<float> extentX, extentY, extentZ;                   // Box half sizes.
+};
+
+#endif // FRUSTUM_CULLER_H
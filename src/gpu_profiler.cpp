@@ -0,0 +1,186 @@
+// Region: Includes
+// This section includes the GPU profiler header and the standard headers it needs.
+#pragma region Includes
+
+// gpu_profiler.cpp
+#include "gpu_profiler.h"           // Include the header file for this module
+
+#include <algorithm>                // For std::min
+#include <stdexcept>                // For standard exception handling (e.g., std::runtime_error)
+
+#pragma endregion
+
+// Region: Lifetime
+// This section checks timestamp support and creates and destroys the query pools.
+#pragma region Lifetime
+
+bool GpuProfiler::init(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, uint32_t queueFamilyIndex, uint32_t frameCount, uint32_t maxPasses)
+{
+    device = logicalDevice;
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    // Zero valid bits means the queue family cannot write timestamps at all.
+    uint32_t validBits = queueFamilyIndex < queueFamilyCount ? queueFamilies[queueFamilyIndex].timestampValidBits : 0;
+    if (validBits == 0)
+    {
+        return false;
+    }
+    timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    nanosecondsPerTick = properties.limits.timestampPeriod;
+
+    queriesPerSlot = maxPasses * 2;
+    results.resize(queriesPerSlot * 2);
+    pending.assign(frameCount, 0);
+    queryPools.resize(frameCount, VK_NULL_HANDLE);
+
+    VkQueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = queriesPerSlot;
+
+    for (VkQueryPool& queryPool : queryPools)
+    {
+        if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &queryPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create timestamp query pool!");
+        }
+    }
+    return true;
+}
+
+void GpuProfiler::cleanup()
+{
+    for (VkQueryPool queryPool : queryPools)
+    {
+        vkDestroyQueryPool(device, queryPool, nullptr);
+    }
+    queryPools.clear();
+    pending.clear();
+}
+
+uint32_t GpuProfiler::addPass(const std::string& name)
+{
+    if ((passes.size() + 1) * 2 > queriesPerSlot && isEnabled())
+    {
+        throw std::runtime_error("too many GPU profiler passes!");
+    }
+    passes.push_back(Pass());
+    passes.back().name = name;
+    return static_cast<uint32_t>(passes.size() - 1);
+}
+
+#pragma endregion
+
+// Region: Recording
+// This section records the query reset and the timestamps of each pass.
+#pragma region Recording
+
+void GpuProfiler::beginFrame(VkCommandBuffer commandBuffer, uint32_t slot)
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+    vkCmdResetQueryPool(commandBuffer, queryPools[slot], 0, queriesPerSlot);
+}
+
+// TOP_OF_PIPE / BOTTOM_OF_PIPE: the begin is written once the previous commands have started, and the end once
+// every command of the pass has completed.
+void GpuProfiler::beginPass(VkCommandBuffer commandBuffer, uint32_t slot, uint32_t pass)
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPools[slot], pass * 2);
+}
+
+void GpuProfiler::endPass(VkCommandBuffer commandBuffer, uint32_t slot, uint32_t pass)
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPools[slot], pass * 2 + 1);
+}
+
+void GpuProfiler::frameSubmitted(uint32_t slot)
+{
+    if (isEnabled())
+    {
+        pending[slot] = 1;
+    }
+}
+
+#pragma endregion
+
+// Region: Results
+// This section reads the timestamps back and keeps the rolling per-pass times.
+#pragma region Results
+
+// The slot's fence has signaled, so every query written by the submission is available and the read returns at
+// once. Queries the submission did not write stay reset and report zero availability.
+void GpuProfiler::collect(uint32_t slot)
+{
+    if (!isEnabled() || !pending[slot])
+    {
+        return;
+    }
+    pending[slot] = 0;
+
+    uint32_t queryCount = static_cast<uint32_t>(passes.size()) * 2;
+    if (queryCount == 0)
+    {
+        return;
+    }
+    VkResult result = vkGetQueryPoolResults(device, queryPools[slot], 0, queryCount, queryCount * 2 * sizeof(uint64_t), results.data(),
+                                            2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (result != VK_SUCCESS && result != VK_NOT_READY)
+    {
+        return;
+    }
+
+    lastFrameMilliseconds = 0.0;
+    for (uint32_t pass = 0; pass < passes.size(); pass++)
+    {
+        const uint64_t* begin = &results[pass * 4];     // Timestamp, availability.
+        const uint64_t* end = &results[pass * 4 + 2];
+        if (begin[1] == 0 || end[1] == 0)
+        {
+            continue; // Not recorded in this submission.
+        }
+
+        uint64_t ticks = (end[0] - begin[0]) & timestampMask;
+        Pass& entry = passes[pass];
+        entry.lastMilliseconds = static_cast<double>(ticks) * nanosecondsPerTick / 1000000.0;
+        entry.history[entry.sampleCount % GPU_PROFILER_HISTORY] = entry.lastMilliseconds;
+        entry.sampleCount++;
+        lastFrameMilliseconds += entry.lastMilliseconds;
+    }
+}
+
+double GpuProfiler::getAverageMilliseconds(uint32_t pass) const
+{
+    const Pass& entry = passes[pass];
+    uint32_t count = std::min(entry.sampleCount, GPU_PROFILER_HISTORY);
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    double total = 0.0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        total += entry.history[i];
+    }
+    return total / count;
+}
+
+#pragma endregion
@@ -0,0 +1,77 @@
+// gpu_profiler.h
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include <vulkan/vulkan.h>          // Vulkan types (VkQueryPool, VkCommandBuffer, ...)
+#include <cstdint>                  // Necessary for uint32_t / uint64_t
+#include <string>                   // For the pass names
+#include <vector>                   // For the per-slot pools and per-pass histories
+
+const uint32_t GPU_PROFILER_HISTORY = 64; // Frames averaged by getAverageMilliseconds.
+
+// GPU pass timer built on timestamp queries.
+// Each frame slot owns a query pool with a begin/end timestamp pair per pass. The command buffer of a slot resets
+// its pool and writes the timestamps around each pass; the results are read once the slot's fence has signaled,
+// a few frames later, without VK_QUERY_RESULT_WAIT_BIT. Availability is queried too, so passes that a submission
+// did not record are simply skipped. Tick deltas are converted to milliseconds with timestampPeriod.
+class GpuProfiler
+{
+public:
+    // Creates the pools for frameCount slots and up to maxPasses passes. Returns false (and creates nothing) when
+    // the queue family has no timestamp support.
+    bool init(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t queueFamilyIndex, uint32_t frameCount, uint32_t maxPasses);
+
+    // Destroys the query pools.
+    void cleanup();
+
+    // Registers a pass and returns its index. Call before recording.
+    uint32_t addPass(const std::string& name);
+
+    // Records the reset of the slot's queries. Must be recorded outside any render pass, before the first beginPass.
+    void beginFrame(VkCommandBuffer commandBuffer, uint32_t slot);
+
+    // Writes the begin / end timestamp of a pass.
+    void beginPass(VkCommandBuffer commandBuffer, uint32_t slot, uint32_t pass);
+    void endPass(VkCommandBuffer commandBuffer, uint32_t slot, uint32_t pass);
+
+    // Marks that a command buffer recorded with beginFrame was submitted for the slot.
+    void frameSubmitted(uint32_t slot);
+
+    // Reads the timestamps of the last submission of the slot. Call after its fence was waited on.
+    void collect(uint32_t slot);
+
+    bool isEnabled() const { return !queryPools.empty(); }
+    uint32_t getPassCount() const { return static_cast<uint32_t>(passes.size()); }
+    const std::string& getPassName(uint32_t pass) const { return passes[pass].name; }
+
+    // GPU time of the last collected frame, and the average over the last GPU_PROFILER_HISTORY collected frames.
+    double getLastMilliseconds(uint32_t pass) const { return passes[pass].lastMilliseconds; }
+    double getAverageMilliseconds(uint32_t pass) const;
+
+    // Sum of the passes measured in the last collected frame.
+    double getLastFrameMilliseconds() const { return lastFrameMilliseconds; }
+
+    // Frames in which the pass was measured.
+    uint32_t getSampleCount(uint32_t pass) const { return passes[pass].sampleCount; }
+
+private:
+    struct Pass
+    {
+        std::string name;
+        double lastMilliseconds = 0.0;
+        double history[GPU_PROFILER_HISTORY] = {};      // Ring of the last measurements.
+        uint32_t sampleCount = 0;                       // Measurements taken (the ring holds the last min(count, history)).
+    };
+
+    VkDevice device = VK_NULL_HANDLE;                   // Logical device.
+    std::vector<VkQueryPool> queryPools;                // One per frame slot, 2 queries per pass.
+    std::vector<uint8_t> pending;                       // Per slot: a submission wrote the pool since the last collect.
+    std::vector<Pass> passes;                           // Registered passes.
+    uint32_t queriesPerSlot = 0;                        // 2 * maxPasses.
+    uint64_t timestampMask = 0;                         // Valid bits of a timestamp (deltas wrap around).
+    double nanosecondsPerTick = 0.0;                    // VkPhysicalDeviceLimits::timestampPeriod.
+    double lastFrameMilliseconds = 0.0;                 // Total of the passes of the last collected frame.
+    std::vector<uint64_t> results;                      // Scratch for vkGetQueryPoolResults (value, availability pairs).
+};
+
+#endif // GPU_PROFILER_H
@@ -1,31 +1,170 @@
 #include "1_triangle/epic_triangle.h"
 #include "2_raytracing/epic_raytracing.h"
+#include "benchmark.h"
 #include <iostream>
 #include <string>
+#include <cstdlib>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
 
-int main() 
+// Texto de ajuda da linha de comando (Command line help)
+static void printUsage()
 {
-    std::cout << "🔸 Tucoff's Vulkan Sandbox 🔸\n";
-    std::cout << "Projects sumary:\n";
-    std::cout << "  1. Triangle\n";
-    std::cout << "  2. Raytracing\n";
-    std::cout << "Digit the number of the projet to show: ";
+    std::cout << "Usage: VulkanSandbox [project] [options]\n"
+              << "  project                 1 / triangle or 2 / raytracing (asked for when omitted)\n"
+              << "  --headless              render offscreen: no window, surface or swap chain\n"
+              << "  --frames N              measured frames before exiting (headless default: 100)\n"
+              << "  --warmup N              frames rendered before the measurement starts\n"
+              << "  --width N, --height N   window / offscreen image size\n"
+              << "  --resolution WxH        both sizes at once\n"
+              << "  --present-mode MODE     immediate, mailbox, fifo or fifo-relaxed\n"
+              << "  --format FORMAT         report format: text or json (json without --output: other output goes to stderr)\n"
+              << "  --output FILE           append the report to FILE instead of printing it\n"
+              << "  --readback FILE         headless: write the last frame to FILE (binary PPM)\n";
+}
 
+// Reads an unsigned 32-bit number; false if the text is not one (signs, trailing characters and overflow included).
+static bool parseNumber(const std::string& text, uint32_t& value)
+{
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0])))
+    {
+        return false; // strtoul would accept a sign or leading spaces, and wrap "-1" around.
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    unsigned long number = std::strtoul(text.c_str(), &end, 10);
+    if (*end != '\0' || errno == ERANGE || number > UINT32_MAX)
+    {
+        return false;
+    }
+    value = static_cast<uint32_t>(number);
+    return true;
+}
+
+// Fills the project number and the run options from the arguments. Returns false (after printing why) on a bad argument.
+static bool parseArguments(int argc, char** argv, int& project, RunOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        std::string value = hasValue ? argv[i + 1] : "";
+        bool valid = true;
+
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            std::exit(0);
+        }
+        else if (arg == "--headless")
+        {
+            options.headless = true;
+            continue;
+        }
+        else if (arg == "--frames")
+        {
+            valid = parseNumber(value, options.frameCount);
+        }
+        else if (arg == "--warmup")
+        {
+            valid = parseNumber(value, options.warmupFrames);
+        }
+        else if (arg == "--width")
+        {
+            valid = parseNumber(value, options.width) && options.width > 0;
+        }
+        else if (arg == "--height")
+        {
+            valid = parseNumber(value, options.height) && options.height > 0;
+        }
+        else if (arg == "--resolution")
+        {
+            size_t separator = value.find('x');
+            valid = separator != std::string::npos && parseNumber(value.substr(0, separator), options.width)
+                 && parseNumber(value.substr(separator + 1), options.height) && options.width > 0 && options.height > 0;
+        }
+        else if (arg == "--present-mode")
+        {
+            valid = parsePresentMode(value, options.presentMode);
+        }
+        else if (arg == "--format")
+        {
+            valid = value == "text" || value == "json";
+            options.reportFormat = value == "json" ? ReportFormat::Json : ReportFormat::Text;
+        }
+        else if (arg == "--output")
+        {
+            options.reportFile = value;
+        }
+        else if (arg == "--readback")
+        {
+            options.readbackFile = value;
+        }
+        else if (arg == "1" || arg == "triangle")
+        {
+            project = 1;
+            continue;
+        }
+        else if (arg == "2" || arg == "raytracing")
+        {
+            project = 2;
+            continue;
+        }
+        else
+        {
+            std::cerr << "Opcao desconhecida: " << arg << " (--help lists the options)\n";
+            return false;
+        }
+
+        // Every option that reaches this point takes a value.
+        if (!hasValue || !valid)
+        {
+            std::cerr << "Valor invalido para " << arg << ": " << value << "\n";
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
     int n = 0;
-    std::cin >> n;
+    RunOptions options;
+    if (!parseArguments(argc, argv, n, options))
+    {
+        return 1;
+    }
+
+    // A JSON report on stdout must be the only thing there: everything the run writes to std::cout (progress messages,
+    // statistics, the headless title) goes to stderr instead. writeReport uses the C stdout stream, which stays put.
+    if (options.reportFormat == ReportFormat::Json && options.reportFile.empty())
+    {
+        std::cout.rdbuf(std::cerr.rdbuf());
+    }
+
+    // Without a project on the command line, ask for one.
+    if (n == 0)
+    {
+        std::cout << "🔸 Tucoff's Vulkan Sandbox 🔸\n";
+        std::cout << "Projects sumary:\n";
+        std::cout << "  1. Triangle\n";
+        std::cout << "  2. Raytracing\n";
+        std::cout << "Digit the number of the projet to show: ";
 
-    switch (n) 
+        std::cin >> n;
+    }
+
+    switch (n)
     {
         case 1:
-            triangle();
-            break;
+            return triangle(options);
         case 2:
-            raytrace();
-            break;
+            return raytrace(options);
         default:
             std::cerr << "Projeto inválido. Nada será executado.\n";
             return 1;
     }
-
-    return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,148 @@
+// Region: Includes
+// This section includes the mapped file header and the platform mapping API.
+#pragma region Includes
+
+// mapped_file.cpp
+#include "mapped_file.h"           // Include the header file for this module
+
+#if defined(_WIN32) || defined(_WIN64)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>            // For CreateFileMapping / MapViewOfFile
+#else
+    #include <fcntl.h>              // For open
+    #include <sys/mman.h>           // For mmap / munmap
+    #include <sys/stat.h>           // For fstat (file size)
+    #include <unistd.h>             // For close
+#endif
+
+#pragma endregion
+
+// Region: Public Interface
+// This section implements mapping and unmapping the file on each platform.
+#pragma region Public Interface
+
+// Unmaps the file if the owner forgot to call close().
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+
+// Opens the file and maps a read-only view of it.
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file); // Empty files cannot be mapped.
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (address == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    view = address;
+    length = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+// Unmaps the view and closes the handles.
+void MappedFile::close()
+{
+    if (view != nullptr)
+    {
+        UnmapViewOfFile(view);
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+    }
+    view = nullptr;
+    length = 0;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+}
+
+// Windows has no portable read-ahead hint for a view (PrefetchVirtualMemory needs Windows 8); the cache manager
+// already detects sequential access.
+void MappedFile::adviseSequential() const
+{
+}
+
+#else
+
+// Opens the file and maps it read-only and private.
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        ::close(file); // Empty files cannot be mapped.
+        return false;
+    }
+
+    void* address = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file); // The mapping keeps its own reference to the file.
+    if (address == MAP_FAILED)
+    {
+        return false;
+    }
+
+    view = address;
+    length = static_cast<size_t>(status.st_size);
+    return true;
+}
+
+// Unmaps the file.
+void MappedFile::close()
+{
+    if (view != nullptr)
+    {
+        munmap(const_cast<void*>(view), length);
+    }
+    view = nullptr;
+    length = 0;
+}
+
+// Asks for sequential read-ahead and starts reading the whole file in the background.
+void MappedFile::adviseSequential() const
+{
+    if (view != nullptr)
+    {
+        posix_madvise(const_cast<void*>(view), length, POSIX_MADV_SEQUENTIAL);
+        posix_madvise(const_cast<void*>(view), length, POSIX_MADV_WILLNEED);
+    }
+}
+
+#endif
+
+#pragma endregion
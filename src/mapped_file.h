@@ -0,0 +1,47 @@
+// mapped_file.h
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>                  // Necessary for size_t
+#include <string>                   // For the file path
+
+// A read-only memory mapping of a whole file.
+// The OS pages the contents in on demand and shares them with the page cache, so large read-only assets
+// (shader packs, meshes) can be used in place without being copied into heap buffers first.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile(); // Unmaps the file if close() was not called.
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps the file. Returns false (and leaves the object closed) if it cannot be opened or mapped.
+    bool open(const std::string& path);
+
+    // Unmaps the file. Pointers returned by data() become invalid.
+    void close();
+
+    // Tells the OS the mapping will be read front to back, so it reads ahead aggressively instead of faulting
+    // in one page at a time. Large files then load at close to the disk bandwidth.
+    void adviseSequential() const;
+
+    // Start of the mapping (page aligned), or nullptr when closed.
+    const void* data() const { return view; }
+
+    // Size of the file in bytes.
+    size_t size() const { return length; }
+
+    bool isOpen() const { return view != nullptr; }
+
+private:
+    const void* view = nullptr;                     // Base address of the mapping.
+    size_t length = 0;                              // Mapped size (the whole file).
+#if defined(_WIN32) || defined(_WIN64)
+    void* fileHandle = nullptr;                     // HANDLE of the open file.
+    void* mappingHandle = nullptr;                  // HANDLE of the file mapping object.
+#endif
+};
+
+#endif // MAPPED_FILE_H
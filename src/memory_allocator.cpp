@@ -0,0 +1,471 @@
+// Region: Includes
+// This section includes the allocator header and the standard headers used by the buddy allocator.
+#pragma region Includes
+
+// memory_allocator.cpp
+#include "memory_allocator.h"      // Include the header file for this module
+
+#include <algorithm>                // Necessary for std::max and std::min
+#include <iomanip>                  // For formatting the statistics report
+#include <iostream>                 // For reporting allocations still live at cleanup
+#include <set>                      // For the ordered free lists of every buddy order
+#include <sstream>                  // For building the formatted byte counts
+#include <stdexcept>                // For standard exception handling (e.g., std::runtime_error)
+
+#pragma endregion
+
+// Region: Buddy Blocks
+// This section defines the memory block and the helpers used to convert sizes into buddy orders.
+#pragma region Buddy Blocks
+
+// Smallest node handed out by the buddy allocator (2^8 = 256 bytes), which also covers the usual buffer alignments.
+static const uint32_t MIN_BUDDY_ORDER = 8;
+// Smallest block size used when a heap is too small for the preferred block size.
+static const VkDeviceSize MIN_BLOCK_SIZE = 1ull * 1024 * 1024;
+
+// A large VkDeviceMemory split into power-of-two nodes.
+struct MemoryBlock
+{
+    VkDeviceMemory memory = VK_NULL_HANDLE;             // Device memory object backing the whole block.
+    void* mappedData = nullptr;                         // Persistent mapping of the block (HOST_VISIBLE types only).
+    uint32_t order = 0;                                 // log2 of the block size.
+    uint32_t allocationCount = 0;                       // Live sub-allocations inside the block.
+    std::vector<std::set<VkDeviceSize>> freeLists;      // Free node offsets, indexed by (order - MIN_BUDDY_ORDER).
+};
+
+// Returns the smallest order whose node size is at least `size`.
+static uint32_t ceilLog2(VkDeviceSize size)
+{
+    uint32_t order = 0;
+    while ((VkDeviceSize(1) << order) < size)
+    {
+        order++;
+    }
+    return order;
+}
+
+// Returns the largest order whose node size is at most `size`.
+static uint32_t floorLog2(VkDeviceSize size)
+{
+    uint32_t order = 0;
+    while ((VkDeviceSize(1) << (order + 1)) <= size)
+    {
+        order++;
+    }
+    return order;
+}
+
+// Formats a byte count with a binary unit for the statistics report.
+static std::string formatBytes(VkDeviceSize bytes)
+{
+    const char* units[] = { "B", "KiB", "MiB", "GiB" };
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (value >= 1024.0 && unit < 3)
+    {
+        value /= 1024.0;
+        unit++;
+    }
+
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+    return text.str();
+}
+
+#pragma endregion
+
+// Region: Public Interface
+// This section implements initialization, allocation, release and memory type selection.
+#pragma region Public Interface
+
+DeviceMemoryAllocator::DeviceMemoryAllocator() = default;
+DeviceMemoryAllocator::~DeviceMemoryAllocator() = default;
+
+// Queries the memory properties of the physical device and sizes the blocks of every memory type.
+void DeviceMemoryAllocator::init(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, VkDeviceSize blockSize)
+{
+    device = logicalDevice;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties); // Get the memory types and heaps.
+
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+    bufferImageGranularity = std::max<VkDeviceSize>(deviceProperties.limits.bufferImageGranularity, 1);
+    maxMemoryAllocationCount = deviceProperties.limits.maxMemoryAllocationCount;
+
+    // Blocks must be a power of two so every buddy node stays naturally aligned.
+    preferredBlockSize = VkDeviceSize(1) << floorLog2(std::max(blockSize, MIN_BLOCK_SIZE));
+
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+    {
+        // Small heaps (e.g. 256 MiB BAR windows) get smaller blocks so a single block never dominates them.
+        VkDeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[i].heapIndex].size;
+        VkDeviceSize typeBlockSize = preferredBlockSize;
+        while (typeBlockSize > MIN_BLOCK_SIZE && typeBlockSize > heapSize / 8)
+        {
+            typeBlockSize >>= 1;
+        }
+        pools[i].blockSize = typeBlockSize;
+    }
+}
+
+// Frees every block that is still alive.
+void DeviceMemoryAllocator::cleanup()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Every resource should have been freed by now. Sub-allocations die with their blocks, but dedicated memory is
+    // only known to its MemoryAllocation handle, so whatever is left of it leaks; report both.
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+    {
+        const MemoryHeapStatistics& stats = heapStatistics[i];
+        if (stats.allocationCount > 0 || stats.dedicatedCount > 0)
+        {
+            std::cerr << "Memory allocator: heap " << i << " still has " << stats.allocationCount << " sub-allocations ("
+                      << formatBytes(stats.requestedBytes) << ") and " << stats.dedicatedCount << " dedicated allocations ("
+                      << formatBytes(stats.dedicatedBytes) << ", leaked) at cleanup" << std::endl;
+        }
+    }
+
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+    {
+        for (auto& block : pools[i].blocks)
+        {
+            if (block->mappedData != nullptr)
+            {
+                vkUnmapMemory(device, block->memory); // Unmap the persistent mapping before freeing.
+            }
+            vkFreeMemory(device, block->memory, nullptr);
+            if (telemetry != nullptr)
+            {
+                telemetry->recordDeviceMemoryFree(i, pools[i].blockSize);
+            }
+        }
+        pools[i].blocks.clear();
+    }
+
+    deviceAllocationCount = 0;
+    heapStatistics.fill(MemoryHeapStatistics{}); // A later init() starts from zero.
+}
+
+// Allocates memory for a resource with the given requirements and property flags.
+MemoryAllocation DeviceMemoryAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, MemoryTag tag, bool linearResource)
+{
+    if (requirements.size == 0)
+    {
+        throw std::runtime_error("failed to allocate memory: requested size is zero!");
+    }
+
+    MemoryAllocation allocation{};
+    allocation.size = requirements.size;
+    allocation.tag = tag;
+    allocation.memoryTypeIndex = findMemoryTypeIndex(requirements.memoryTypeBits, properties); // Honor the requested property flags.
+    uint32_t heapIndex = memoryProperties.memoryTypes[allocation.memoryTypeIndex].heapIndex;
+
+    // Reserve a node large enough for the size and the alignment; optimal images also cover a whole granularity page.
+    VkDeviceSize reservedSize = std::max(requirements.size, requirements.alignment);
+    if (!linearResource)
+    {
+        reservedSize = std::max(reservedSize, bufferImageGranularity);
+    }
+    uint32_t order = std::max(ceilLog2(reservedSize), MIN_BUDDY_ORDER);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    MemoryTypePool& pool = pools[allocation.memoryTypeIndex];
+    MemoryHeapStatistics& stats = heapStatistics[heapIndex];
+
+    // Resources larger than half a block get their own VkDeviceMemory instead of pinning a whole block.
+    if ((VkDeviceSize(1) << order) > pool.blockSize / 2)
+    {
+        allocation.memory = allocateDeviceMemory(requirements.size, allocation.memoryTypeIndex, &allocation.mappedData);
+        stats.dedicatedCount++;
+        stats.dedicatedBytes += requirements.size;
+        trackPeak(heapIndex);
+        if (telemetry != nullptr)
+        {
+            telemetry->recordAllocation(allocation.memoryTypeIndex, tag, requirements.size);
+        }
+        return allocation;
+    }
+
+    // Try the existing blocks first, then grow the pool by one block.
+    MemoryBlock* target = nullptr;
+    for (auto& block : pool.blocks)
+    {
+        if (allocateFromBlock(*block, order, allocation.offset))
+        {
+            target = block.get();
+            break;
+        }
+    }
+    if (target == nullptr)
+    {
+        target = createBlock(allocation.memoryTypeIndex);
+        if (!allocateFromBlock(*target, order, allocation.offset))
+        {
+            throw std::runtime_error("failed to sub-allocate from a new memory block!");
+        }
+    }
+
+    target->allocationCount++;
+    allocation.block = target;
+    allocation.order = order;
+    allocation.memory = target->memory;
+    if (target->mappedData != nullptr)
+    {
+        allocation.mappedData = static_cast<char*>(target->mappedData) + allocation.offset;
+    }
+
+    stats.allocationCount++;
+    stats.requestedBytes += requirements.size;
+    stats.reservedBytes += VkDeviceSize(1) << order;
+    trackPeak(heapIndex);
+    if (telemetry != nullptr)
+    {
+        telemetry->recordAllocation(allocation.memoryTypeIndex, tag, requirements.size);
+    }
+
+    return allocation;
+}
+
+// Releases an allocation and resets the handle so it cannot be freed twice.
+void DeviceMemoryAllocator::free(MemoryAllocation& allocation)
+{
+    if (allocation.memory == VK_NULL_HANDLE)
+    {
+        return; // Nothing to free.
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t heapIndex = memoryProperties.memoryTypes[allocation.memoryTypeIndex].heapIndex;
+    MemoryHeapStatistics& stats = heapStatistics[heapIndex];
+    if (telemetry != nullptr)
+    {
+        telemetry->recordFree(allocation.memoryTypeIndex, allocation.tag, allocation.size);
+    }
+
+    if (allocation.block == nullptr)
+    {
+        // Dedicated allocation: give the memory back to the driver.
+        if (allocation.mappedData != nullptr)
+        {
+            vkUnmapMemory(device, allocation.memory);
+        }
+        vkFreeMemory(device, allocation.memory, nullptr);
+        deviceAllocationCount--;
+        if (telemetry != nullptr)
+        {
+            telemetry->recordDeviceMemoryFree(allocation.memoryTypeIndex, allocation.size);
+        }
+        stats.dedicatedCount--;
+        stats.dedicatedBytes -= allocation.size;
+    }
+    else
+    {
+        MemoryBlock* block = allocation.block;
+        freeToBlock(*block, allocation.order, allocation.offset);
+        block->allocationCount--;
+
+        stats.allocationCount--;
+        stats.requestedBytes -= allocation.size;
+        stats.reservedBytes -= VkDeviceSize(1) << allocation.order;
+
+        // Keep one empty block per memory type around to avoid allocate/free churn, release the rest.
+        if (block->allocationCount == 0 && pools[allocation.memoryTypeIndex].blocks.size() > 1)
+        {
+            destroyBlock(allocation.memoryTypeIndex, block);
+        }
+    }
+
+    allocation = MemoryAllocation{};
+}
+
+// Finds a memory type allowed by typeFilter that has all the requested property flags.
+uint32_t DeviceMemoryAllocator::findMemoryTypeIndex(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+{
+    // Iterate through the memory types to find a suitable one.
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+    {
+        // Check if the memory type is suitable based on the type filter and properties.
+        if ((typeFilter & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+        {
+            return i; // Return the index of the suitable memory type.
+        }
+    }
+
+    throw std::runtime_error("failed to find suitable memory type!"); // Throw an error if no suitable memory type is found.
+}
+
+// Returns a copy of the counters of a memory heap.
+MemoryHeapStatistics DeviceMemoryAllocator::getHeapStatistics(uint32_t heapIndex) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return heapStatistics[heapIndex];
+}
+
+// Prints a per-heap summary of blocks, allocations and wasted bytes.
+void DeviceMemoryAllocator::printStatistics(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    out << "Device memory: " << deviceAllocationCount << " vkAllocateMemory objects (limit " << maxMemoryAllocationCount << ")\n";
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+    {
+        const MemoryHeapStatistics& stats = heapStatistics[i];
+        bool deviceLocal = (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+
+        out << "  heap " << i << (deviceLocal ? " [device local] " : " [host] ") << formatBytes(memoryProperties.memoryHeaps[i].size) << ": "
+            << stats.blockCount << " blocks (" << formatBytes(stats.blockBytes) << "), "
+            << stats.allocationCount << " allocations (" << formatBytes(stats.requestedBytes) << " requested, "
+            << formatBytes(stats.reservedBytes) << " reserved), "
+            << stats.dedicatedCount << " dedicated (" << formatBytes(stats.dedicatedBytes) << "), "
+            << "peak " << formatBytes(stats.peakReservedBytes) << "\n";
+    }
+}
+
+#pragma endregion
+
+// Region: Block Management
+// This section implements block creation/destruction and the buddy split/merge logic.
+#pragma region Block Management
+
+// Allocates a new block for a memory type, with a single free node covering the whole block.
+MemoryBlock* DeviceMemoryAllocator::createBlock(uint32_t memoryTypeIndex)
+{
+    MemoryTypePool& pool = pools[memoryTypeIndex];
+
+    auto block = std::make_unique<MemoryBlock>();
+    block->memory = allocateDeviceMemory(pool.blockSize, memoryTypeIndex, &block->mappedData);
+    block->order = floorLog2(pool.blockSize);
+    block->freeLists.resize(block->order - MIN_BUDDY_ORDER + 1);
+    block->freeLists.back().insert(0); // The whole block is one free node.
+
+    MemoryHeapStatistics& stats = heapStatistics[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex];
+    stats.blockCount++;
+    stats.blockBytes += pool.blockSize;
+
+    pool.blocks.push_back(std::move(block));
+    return pool.blocks.back().get();
+}
+
+// Frees an empty block and removes it from its pool.
+void DeviceMemoryAllocator::destroyBlock(uint32_t memoryTypeIndex, MemoryBlock* block)
+{
+    MemoryTypePool& pool = pools[memoryTypeIndex];
+
+    if (block->mappedData != nullptr)
+    {
+        vkUnmapMemory(device, block->memory);
+    }
+    vkFreeMemory(device, block->memory, nullptr);
+    deviceAllocationCount--;
+    if (telemetry != nullptr)
+    {
+        telemetry->recordDeviceMemoryFree(memoryTypeIndex, pool.blockSize);
+    }
+
+    MemoryHeapStatistics& stats = heapStatistics[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex];
+    stats.blockCount--;
+    stats.blockBytes -= pool.blockSize;
+
+    pool.blocks.erase(std::remove_if(pool.blocks.begin(), pool.blocks.end(),
+        [block](const std::unique_ptr<MemoryBlock>& candidate) { return candidate.get() == block; }), pool.blocks.end());
+}
+
+// Takes the lowest free node of at least the requested order, splitting larger nodes as needed.
+bool DeviceMemoryAllocator::allocateFromBlock(MemoryBlock& block, uint32_t order, VkDeviceSize& offset)
+{
+    // Find the smallest order with a free node.
+    uint32_t current = order;
+    while (current <= block.order && block.freeLists[current - MIN_BUDDY_ORDER].empty())
+    {
+        current++;
+    }
+    if (current > block.order)
+    {
+        return false; // The block is too fragmented or full.
+    }
+
+    auto& freeList = block.freeLists[current - MIN_BUDDY_ORDER];
+    offset = *freeList.begin(); // Lowest address first keeps the block compact.
+    freeList.erase(freeList.begin());
+
+    // Split the node down to the requested order, returning the upper halves to the free lists.
+    while (current > order)
+    {
+        current--;
+        block.freeLists[current - MIN_BUDDY_ORDER].insert(offset + (VkDeviceSize(1) << current));
+    }
+
+    return true;
+}
+
+// Returns a node to the block, merging it with its buddy for as long as the buddy is free too.
+void DeviceMemoryAllocator::freeToBlock(MemoryBlock& block, uint32_t order, VkDeviceSize offset)
+{
+    while (order < block.order)
+    {
+        VkDeviceSize buddy = offset ^ (VkDeviceSize(1) << order);
+        auto& freeList = block.freeLists[order - MIN_BUDDY_ORDER];
+        auto it = freeList.find(buddy);
+        if (it == freeList.end())
+        {
+            break; // Buddy is in use, stop merging.
+        }
+
+        freeList.erase(it);
+        offset = std::min(offset, buddy);
+        order++;
+    }
+
+    block.freeLists[order - MIN_BUDDY_ORDER].insert(offset);
+}
+
+// Calls vkAllocateMemory and maps the memory persistently when it is host visible.
+VkDeviceMemory DeviceMemoryAllocator::allocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, void** mappedData)
+{
+    if (maxMemoryAllocationCount != 0 && deviceAllocationCount >= maxMemoryAllocationCount)
+    {
+        throw std::runtime_error("failed to allocate device memory: maxMemoryAllocationCount reached!");
+    }
+
+    VkMemoryAllocateInfo allocInfo{}; // Create a memory allocate info structure.
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO; // Specify the type of the structure.
+    allocInfo.allocationSize = size; // Set the allocation size.
+    allocInfo.memoryTypeIndex = memoryTypeIndex; // Set the memory type index.
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    if (vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate device memory!"); // Throw an error if memory allocation fails.
+    }
+
+    *mappedData = nullptr;
+    if (memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        // Map once for the lifetime of the memory; vkMapMemory cannot be called again on the same memory object.
+        if (vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, mappedData) != VK_SUCCESS)
+        {
+            vkFreeMemory(device, memory, nullptr); // Not counted yet, so the counters stay in sync.
+            *mappedData = nullptr;
+            throw std::runtime_error("failed to map device memory!");
+        }
+    }
+
+    // Counted only once the memory is usable.
+    deviceAllocationCount++;
+    if (telemetry != nullptr)
+    {
+        telemetry->recordDeviceMemory(memoryTypeIndex, size);
+    }
+
+    return memory;
+}
+
+// Records the highest reserved byte count of a heap.
+void DeviceMemoryAllocator::trackPeak(uint32_t heapIndex)
+{
+    MemoryHeapStatistics& stats = heapStatistics[heapIndex];
+    stats.peakReservedBytes = std::max(stats.peakReservedBytes, stats.reservedBytes + stats.dedicatedBytes);
+}
+
+#pragma endregion
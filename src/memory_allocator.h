@@ -0,0 +1,109 @@
+// memory_allocator.h
+#ifndef MEMORY_ALLOCATOR_H
+#define MEMORY_ALLOCATOR_H
+
+#include <vulkan/vulkan.h>          // Vulkan types (VkDeviceMemory, VkMemoryRequirements, ...)
+#include "memory_telemetry.h"       // For the usage tags and the telemetry the allocations are reported to
+#include <array>                    // For the per-heap statistics table
+#include <cstdint>                  // Necessary for uint32_t
+#include <memory>                   // For std::unique_ptr owning the memory blocks
+#include <mutex>                    // For serializing allocations coming from several threads
+#include <ostream>                  // For printing the statistics report
+#include <vector>                   // For using std::vector dynamic arrays
+
+struct MemoryBlock; // A large VkDeviceMemory that is split between many allocations (defined in memory_allocator.cpp).
+
+// A sub-allocation handed out by the DeviceMemoryAllocator.
+// Resources are bound to (memory, offset); mappedData is only valid for HOST_VISIBLE memory types.
+struct MemoryAllocation
+{
+    VkDeviceMemory memory = VK_NULL_HANDLE; // Device memory object that backs this allocation.
+    VkDeviceSize offset = 0;                // Offset of the allocation inside the memory object.
+    VkDeviceSize size = 0;                  // Size that was requested by the caller.
+    uint32_t memoryTypeIndex = 0;           // Memory type the allocation was made from.
+    void* mappedData = nullptr;             // Host pointer to the first byte of the allocation (persistently mapped).
+    MemoryTag tag = MemoryTag::Other;       // What the memory is used for (reported to the telemetry).
+
+    MemoryBlock* block = nullptr;           // Owning block, or nullptr for dedicated allocations.
+    uint32_t order = 0;                     // Buddy order (log2 of the reserved size) inside the owning block.
+};
+
+// Per-heap counters, updated on every allocation and free.
+struct MemoryHeapStatistics
+{
+    uint32_t blockCount = 0;                // Number of VkDeviceMemory blocks used for sub-allocation.
+    VkDeviceSize blockBytes = 0;            // Total bytes reserved by those blocks.
+    uint32_t dedicatedCount = 0;            // Number of allocations that got their own VkDeviceMemory.
+    VkDeviceSize dedicatedBytes = 0;        // Total bytes of dedicated allocations.
+    uint32_t allocationCount = 0;           // Number of live sub-allocations.
+    VkDeviceSize requestedBytes = 0;        // Bytes requested by live allocations.
+    VkDeviceSize reservedBytes = 0;         // Bytes reserved by live sub-allocations (power-of-two rounded).
+    VkDeviceSize peakReservedBytes = 0;     // Highest value reservedBytes + dedicatedBytes ever reached.
+};
+
+// Sub-allocating device memory allocator.
+// Memory is requested from the driver in large blocks (one pool of blocks per memory type) and split
+// with a buddy allocator, so thousands of buffers only cost a handful of vkAllocateMemory calls.
+// Buddy nodes are naturally aligned to their size, which covers both VkMemoryRequirements::alignment and
+// bufferImageGranularity (optimal-tiling images are rounded up to at least one granularity page).
+class DeviceMemoryAllocator
+{
+public:
+    DeviceMemoryAllocator();
+    ~DeviceMemoryAllocator(); // Defined in the .cpp, where MemoryBlock is a complete type.
+
+    // Queries the memory properties of the physical device. Must be called before any allocation.
+    void init(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize preferredBlockSize = 64ull * 1024 * 1024);
+
+    // Frees every block and resets the statistics. All allocations must have been released before this call; any that
+    // were not are reported to stderr (dedicated ones leak, since only their MemoryAllocation knows their memory).
+    void cleanup();
+
+    // Reports every allocation, free and vkAllocateMemory object to telemetry from now on (nullptr to stop).
+    void setTelemetry(MemoryTelemetry* memoryTelemetry) { telemetry = memoryTelemetry; }
+
+    // Allocates memory that satisfies the requirements and has (at least) the requested property flags.
+    // tag says what the memory is for. linearResource must be false for optimal-tiling images so they never share a
+    // granularity page with buffers.
+    MemoryAllocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, MemoryTag tag = MemoryTag::Other, bool linearResource = true);
+
+    // Returns an allocation to its block (or frees its dedicated memory) and resets the handle.
+    void free(MemoryAllocation& allocation);
+
+    // Finds a memory type allowed by typeFilter that has all the requested property flags.
+    uint32_t findMemoryTypeIndex(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+    // Returns the counters of a memory heap.
+    MemoryHeapStatistics getHeapStatistics(uint32_t heapIndex) const;
+
+    // Prints a per-heap summary of blocks, allocations and wasted bytes.
+    void printStatistics(std::ostream& out) const;
+
+private:
+    // Blocks of a single memory type.
+    struct MemoryTypePool
+    {
+        VkDeviceSize blockSize = 0;                         // Size of every block of this memory type.
+        std::vector<std::unique_ptr<MemoryBlock>> blocks;   // Blocks currently allocated from the driver.
+    };
+
+    MemoryBlock* createBlock(uint32_t memoryTypeIndex);
+    void destroyBlock(uint32_t memoryTypeIndex, MemoryBlock* block);
+    bool allocateFromBlock(MemoryBlock& block, uint32_t order, VkDeviceSize& offset);
+    void freeToBlock(MemoryBlock& block, uint32_t order, VkDeviceSize offset);
+    VkDeviceMemory allocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, void** mappedData);
+    void trackPeak(uint32_t heapIndex);
+
+    VkDevice device = VK_NULL_HANDLE;                                       // Logical device the memory is allocated from.
+    VkPhysicalDeviceMemoryProperties memoryProperties = {};                 // Memory types and heaps of the physical device.
+    VkDeviceSize bufferImageGranularity = 1;                                // Page size separating linear and optimal resources.
+    uint32_t maxMemoryAllocationCount = 0;                                  // Driver limit on live vkAllocateMemory objects.
+    uint32_t deviceAllocationCount = 0;                                     // Live vkAllocateMemory objects (blocks + dedicated).
+    VkDeviceSize preferredBlockSize = 0;                                    // Upper bound for the block size of every memory type.
+    std::array<MemoryTypePool, VK_MAX_MEMORY_TYPES> pools;                  // One pool of blocks per memory type.
+    std::array<MemoryHeapStatistics, VK_MAX_MEMORY_HEAPS> heapStatistics;   // Counters for every memory heap.
+    mutable std::mutex mutex;                                               // Guards pools and statistics.
+    MemoryTelemetry* telemetry = nullptr;                                   // Optional usage and budget tracking.
+};
+
+#endif // MEMORY_ALLOCATOR_H
@@ -0,0 +1,214 @@
+// Region: Includes
+// This section includes the memory telemetry header and the standard headers used by the reports.
+#pragma region Includes
+
+// memory_telemetry.cpp
+#include "memory_telemetry.h"       // Include the header file for this module
+
+#include <algorithm>                // Necessary for std::max
+#include <iomanip>                  // For formatting the reports
+#include <sstream>                  // For building the formatted byte counts
+#include <string>                   // For the formatted byte counts
+
+#pragma endregion
+
+// Region: Helpers
+// This section formats the byte counts and updates the counters.
+#pragma region Helpers
+
+// Without VK_EXT_memory_budget the budget is guessed as this fraction of the heap size (the rest is left to the
+// other processes and to the driver's own allocations).
+static const double ESTIMATED_BUDGET_FRACTION = 0.8;
+
+// Formats a byte count with a binary unit.
+static std::string formatBytes(VkDeviceSize bytes)
+{
+    const char* units[] = { "B", "KiB", "MiB", "GiB" };
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (value >= 1024.0 && unit < 3)
+    {
+        value /= 1024.0;
+        unit++;
+    }
+
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+    return text.str();
+}
+
+void MemoryTelemetry::add(MemoryUsageCounters& counters, VkDeviceSize size)
+{
+    counters.allocationCount++;
+    counters.bytes += size;
+    counters.peakBytes = std::max(counters.peakBytes, counters.bytes);
+}
+
+void MemoryTelemetry::remove(MemoryUsageCounters& counters, VkDeviceSize size)
+{
+    counters.allocationCount--;
+    counters.bytes -= size;
+}
+
+const char* MemoryTelemetry::getTagName(MemoryTag tag)
+{
+    switch (tag)
+    {
+    case MemoryTag::Vertex:
+        return "vertex";
+    case MemoryTag::Index:
+        return "index";
+    case MemoryTag::Uniform:
+        return "uniform";
+    case MemoryTag::Staging:
+        return "staging";
+    case MemoryTag::Storage:
+        return "storage";
+    case MemoryTag::Image:
+        return "image";
+    default:
+        return "other";
+    }
+}
+
+#pragma endregion
+
+// Region: Tracking
+// This section records the allocations reported by the allocator.
+#pragma region Tracking
+
+void MemoryTelemetry::init(VkPhysicalDevice device, bool budgetExtensionEnabled, float threshold)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    physicalDevice = device;
+    budgetExtension = budgetExtensionEnabled;
+    warningThreshold = threshold;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+}
+
+void MemoryTelemetry::recordAllocation(uint32_t memoryTypeIndex, MemoryTag tag, VkDeviceSize size)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    add(heapResources[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex], size);
+    add(typeResources[memoryTypeIndex], size);
+    add(tagResources[static_cast<uint32_t>(tag)], size);
+}
+
+void MemoryTelemetry::recordFree(uint32_t memoryTypeIndex, MemoryTag tag, VkDeviceSize size)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    remove(heapResources[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex], size);
+    remove(typeResources[memoryTypeIndex], size);
+    remove(tagResources[static_cast<uint32_t>(tag)], size);
+}
+
+void MemoryTelemetry::recordDeviceMemory(uint32_t memoryTypeIndex, VkDeviceSize size)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    add(heapDeviceMemory[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex], size);
+    add(totalDeviceMemory, size);
+}
+
+void MemoryTelemetry::recordDeviceMemoryFree(uint32_t memoryTypeIndex, VkDeviceSize size)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    remove(heapDeviceMemory[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex], size);
+    remove(totalDeviceMemory, size);
+}
+
+VkDeviceSize MemoryTelemetry::getPeakDeviceMemoryBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return totalDeviceMemory.peakBytes;
+}
+
+#pragma endregion
+
+// Region: Budget
+// This section queries the heap budgets and reports the usage.
+#pragma region Budget
+
+// Fills heapBudget and heapUsage. Called with the mutex held.
+void MemoryTelemetry::queryBudget()
+{
+    if (budgetExtension)
+    {
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+        budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+        VkPhysicalDeviceMemoryProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        properties.pNext = &budgetProperties;
+        vkGetPhysicalDeviceMemoryProperties2(physicalDevice, &properties); // Core in Vulkan 1.1.
+
+        for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+        {
+            heapBudget[i] = budgetProperties.heapBudget[i];
+            heapUsage[i] = budgetProperties.heapUsage[i]; // Whole process, including memory not allocated through us.
+        }
+        return;
+    }
+
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+    {
+        heapBudget[i] = static_cast<VkDeviceSize>(memoryProperties.memoryHeaps[i].size * ESTIMATED_BUDGET_FRACTION);
+        heapUsage[i] = heapDeviceMemory[i].bytes;
+    }
+}
+
+bool MemoryTelemetry::checkBudget(std::ostream& out)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    queryBudget();
+
+    bool overThreshold = false;
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+    {
+        bool over = heapBudget[i] > 0 && heapUsage[i] >= heapBudget[i] * static_cast<double>(warningThreshold);
+        if (over && !heapWarned[i])
+        {
+            out << "Warning: memory heap " << i << " uses " << formatBytes(heapUsage[i]) << " of its " << (budgetExtension ? "" : "estimated ")
+                << formatBytes(heapBudget[i]) << " budget (" << static_cast<int>(100.0 * heapUsage[i] / heapBudget[i]) << "%)" << std::endl;
+        }
+        heapWarned[i] = over;
+        overThreshold = overThreshold || over;
+    }
+    return overThreshold;
+}
+
+void MemoryTelemetry::printSummary(std::ostream& out)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    queryBudget();
+
+    out << "Memory budget (" << (budgetExtension ? "VK_EXT_memory_budget" : "estimated, VK_EXT_memory_budget not available") << "):\n";
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+    {
+        bool deviceLocal = (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        out << "  heap " << i << (deviceLocal ? " [device local] " : " [host] ") << formatBytes(memoryProperties.memoryHeaps[i].size) << ": "
+            << "usage " << formatBytes(heapUsage[i]) << " of " << formatBytes(heapBudget[i]) << " budget, "
+            << "device memory " << formatBytes(heapDeviceMemory[i].bytes) << " (peak " << formatBytes(heapDeviceMemory[i].peakBytes) << "), "
+            << heapResources[i].allocationCount << " resources " << formatBytes(heapResources[i].bytes) << " (peak " << formatBytes(heapResources[i].peakBytes) << ")\n";
+    }
+
+    out << "  per memory type:";
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+    {
+        if (typeResources[i].peakBytes > 0) // Only the types something was allocated from.
+        {
+            out << " type " << i << " (heap " << memoryProperties.memoryTypes[i].heapIndex << ") " << formatBytes(typeResources[i].bytes)
+                << " peak " << formatBytes(typeResources[i].peakBytes) << ";";
+        }
+    }
+    out << "\n  per usage:";
+    for (uint32_t i = 0; i < MEMORY_TAG_COUNT; i++)
+    {
+        if (tagResources[i].peakBytes > 0)
+        {
+            out << " " << getTagName(static_cast<MemoryTag>(i)) << " " << formatBytes(tagResources[i].bytes) << " in " << tagResources[i].allocationCount
+                << " allocations, peak " << formatBytes(tagResources[i].peakBytes) << ";";
+        }
+    }
+    out << "\n";
+}
+
+#pragma endregion
@@ -0,0 +1,85 @@
+// memory_telemetry.h
+#ifndef MEMORY_TELEMETRY_H
+#define MEMORY_TELEMETRY_H
+
+#include <vulkan/vulkan.h>          // Vulkan types (VkPhysicalDevice, VkDeviceSize, ...)
+#include <array>                    // For the per-heap / per-type / per-tag tables
+#include <cstdint>                  // Necessary for uint32_t
+#include <mutex>                    // For serializing updates coming from several threads
+#include <ostream>                  // For printing the warnings and the summary
+
+// What an allocation is used for, given by the code that creates the resource.
+enum class MemoryTag : uint32_t
+{
+    Other,
+    Vertex,                         // Vertex and instance buffers.
+    Index,
+    Uniform,
+    Staging,                        // Host-visible upload and readback buffers.
+    Storage,                        // Buffers written by compute passes (object tables, indirect commands).
+    Image,                          // Attachments and offscreen images.
+    Count
+};
+const uint32_t MEMORY_TAG_COUNT = static_cast<uint32_t>(MemoryTag::Count);
+
+// Live and peak usage of one heap, memory type or tag.
+struct MemoryUsageCounters
+{
+    uint32_t allocationCount = 0;
+    VkDeviceSize bytes = 0;
+    VkDeviceSize peakBytes = 0;
+};
+
+// Device memory telemetry.
+// The DeviceMemoryAllocator reports every resource allocation (by memory type and tag) and every vkAllocateMemory
+// object. checkBudget compares each heap with its budget: with VK_EXT_memory_budget the driver reports the budget and
+// the usage of the whole process; without it the budget is estimated as a fraction of the heap size and the usage is
+// the device memory this allocator holds. A heap crossing the warning threshold is reported once, until it drops back.
+class MemoryTelemetry
+{
+public:
+    // Queries the heaps and types. budgetExtensionEnabled: VK_EXT_memory_budget was enabled on the device.
+    void init(VkPhysicalDevice physicalDevice, bool budgetExtensionEnabled, float warningThreshold = 0.9f);
+
+    // Resource allocations, counted by memory type, heap and tag.
+    void recordAllocation(uint32_t memoryTypeIndex, MemoryTag tag, VkDeviceSize size);
+    void recordFree(uint32_t memoryTypeIndex, MemoryTag tag, VkDeviceSize size);
+
+    // vkAllocateMemory / vkFreeMemory of the allocator (blocks and dedicated allocations).
+    void recordDeviceMemory(uint32_t memoryTypeIndex, VkDeviceSize size);
+    void recordDeviceMemoryFree(uint32_t memoryTypeIndex, VkDeviceSize size);
+
+    // Refreshes the budgets and warns about every heap that crossed the threshold. Returns true if any heap is above it.
+    bool checkBudget(std::ostream& out);
+
+    // Prints the budget, usage and peak of every heap, then the usage per memory type and per tag.
+    void printSummary(std::ostream& out);
+
+    // Highest amount of device memory the allocator held at once, over all heaps.
+    VkDeviceSize getPeakDeviceMemoryBytes() const;
+
+    bool hasBudgetExtension() const { return budgetExtension; }
+
+    static const char* getTagName(MemoryTag tag);
+
+private:
+    static void add(MemoryUsageCounters& counters, VkDeviceSize size);
+    static void remove(MemoryUsageCounters& counters, VkDeviceSize size);
+    void queryBudget();
+
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceMemoryProperties memoryProperties = {};
+    bool budgetExtension = false;                                       // Budgets come from VK_EXT_memory_budget.
+    float warningThreshold = 0.9f;                                      // Fraction of the budget that triggers a warning.
+    std::array<MemoryUsageCounters, VK_MAX_MEMORY_HEAPS> heapResources; // Resource allocations per heap.
+    std::array<MemoryUsageCounters, VK_MAX_MEMORY_TYPES> typeResources; // Resource allocations per memory type.
+    std::array<MemoryUsageCounters, MEMORY_TAG_COUNT> tagResources;     // Resource allocations per tag.
+    std::array<MemoryUsageCounters, VK_MAX_MEMORY_HEAPS> heapDeviceMemory; // vkAllocateMemory objects per heap.
+    MemoryUsageCounters totalDeviceMemory;                              // vkAllocateMemory objects over all heaps.
+    std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> heapBudget = {};      // Set by queryBudget.
+    std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> heapUsage = {};       // Set by queryBudget.
+    std::array<bool, VK_MAX_MEMORY_HEAPS> heapWarned = {};              // Warning printed, not yet back under the threshold.
+    mutable std::mutex mutex;                                           // Guards every counter.
+};
+
+#endif // MEMORY_TELEMETRY_H
@@ -0,0 +1,105 @@
+// Region: Includes
+// This section includes the mesh file header and the standard headers it needs.
+#pragma region Includes
+
+// mesh_file.cpp
+#include "mesh_file.h"             // Include the header file for this module
+
+#include <cstring>                  // For memcmp on the magic
+#include <fstream>                  // For writing cooked mesh files
+#include <iostream>                 // For reporting malformed files
+
+#pragma endregion
+
+// Region: Public Interface
+// This section implements mapping the file, validating its header and writing new files.
+#pragma region Public Interface
+
+// Checks that a blob is aligned, has the size implied by its element count and lies inside the file.
+static bool isValidBlob(uint64_t offset, uint64_t bytes, uint64_t elementSize, uint64_t elementCount, uint64_t fileSize)
+{
+    return offset % MESH_BLOB_ALIGNMENT == 0 && bytes == elementSize * elementCount && offset <= fileSize && bytes <= fileSize - offset;
+}
+
+// Maps the file and validates the header against the file size.
+bool MeshFile::open(const std::string& path)
+{
+    close();
+
+    if (!file.open(path))
+    {
+        return false;
+    }
+
+    header = static_cast<const MeshFileHeader*>(file.data()); // The mapping is page aligned.
+    const char* error = nullptr;
+    if (file.size() < sizeof(MeshFileHeader) || memcmp(header->magic, "VMSH", 4) != 0)
+    {
+        error = "not a mesh file";
+    }
+    else if (header->version != MESH_FILE_VERSION)
+    {
+        error = "unsupported version";
+    }
+    else if (header->indexSize != 2 && header->indexSize != 4)
+    {
+        error = "index size must be 2 or 4";
+    }
+    else if (!isValidBlob(header->vertexOffset, header->vertexBytes, header->vertexStride, header->vertexCount, file.size()))
+    {
+        error = "bad vertex blob";
+    }
+    else if (!isValidBlob(header->indexOffset, header->indexBytes, header->indexSize, header->indexCount, file.size()))
+    {
+        error = "bad index blob";
+    }
+
+    if (error != nullptr)
+    {
+        std::cerr << "Mesh file: ignoring " << path << " (" << error << ")" << std::endl;
+        close();
+        return false;
+    }
+
+    file.adviseSequential(); // The blobs are read once, front to back.
+    std::cout << "Mesh file: mapped " << path << " (" << header->vertexCount << " vertices, " << header->indexCount << " "
+              << header->indexSize * 8 << "-bit indices)" << std::endl;
+    return true;
+}
+
+// Unmaps the file.
+void MeshFile::close()
+{
+    file.close();
+    header = nullptr;
+}
+
+// Lays out the header and the two blobs, each blob starting on MESH_BLOB_ALIGNMENT.
+bool MeshFile::write(const std::string& path, MeshFileHeader header, const void* vertexData, const void* indexData)
+{
+    auto align = [](uint64_t offset) { return (offset + MESH_BLOB_ALIGNMENT - 1) / MESH_BLOB_ALIGNMENT * MESH_BLOB_ALIGNMENT; };
+    memcpy(header.magic, "VMSH", 4);
+    header.version = MESH_FILE_VERSION;
+    header.vertexBytes = static_cast<uint64_t>(header.vertexStride) * header.vertexCount;
+    header.indexBytes = static_cast<uint64_t>(header.indexSize) * header.indexCount;
+    header.vertexOffset = align(sizeof(MeshFileHeader));
+    header.indexOffset = align(header.vertexOffset + header.vertexBytes);
+
+    std::ofstream out(path, std::ios::binary);
+    const char padding[MESH_BLOB_ALIGNMENT] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(padding, static_cast<std::streamsize>(header.vertexOffset - sizeof(header)));
+    out.write(static_cast<const char*>(vertexData), static_cast<std::streamsize>(header.vertexBytes));
+    out.write(padding, static_cast<std::streamsize>(header.indexOffset - header.vertexOffset - header.vertexBytes));
+    out.write(static_cast<const char*>(indexData), static_cast<std::streamsize>(header.indexBytes));
+    out.close();
+
+    if (!out)
+    {
+        std::cerr << "Mesh file: failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+#pragma endregion
@@ -0,0 +1,73 @@
+// mesh_file.h
+#ifndef MESH_FILE_H
+#define MESH_FILE_H
+
+#include "mapped_file.h"           // Meshes are used directly from a memory mapping
+
+#include <vulkan/vulkan.h>          // For VkIndexType
+#include <cstddef>                  // Necessary for size_t
+#include <cstdint>                  // Necessary for uint32_t / uint64_t
+#include <string>                   // For the mesh path
+
+const uint32_t MESH_FILE_VERSION = 1;       // Version written in MeshFileHeader::version.
+const uint64_t MESH_BLOB_ALIGNMENT = 64;    // Vertex and index blobs start on a cache line.
+
+// Vertex format tags (MeshFileHeader::vertexFormat).
+const uint32_t MESH_VERTEX_FORMAT_POS2_COLOR3 = 1;  // 2 floats of position then 3 floats of color, 20 bytes.
+
+// MeshFileHeader::flags.
+const uint32_t MESH_FLAG_OPTIMIZED = 1;     // Written by cook_mesh: triangles and vertices are in optimized order.
+
+// On-disk header of a mesh file (little endian, 64 bytes, written by scripts/make_mesh.py and tools/cook_mesh.cpp).
+// The vertex and index blobs are raw arrays ready to be copied into GPU buffers as they are.
+struct MeshFileHeader
+{
+    char magic[4];              // "VMSH"
+    uint32_t version;           // MESH_FILE_VERSION
+    uint32_t vertexFormat;      // Layout tag chosen by the application (checked by the caller).
+    uint32_t vertexStride;      // Bytes per vertex.
+    uint32_t vertexCount;       // Number of vertices.
+    uint32_t indexSize;         // 2 or 4 bytes per index.
+    uint32_t indexCount;        // Number of indices.
+    uint32_t flags;             // MESH_FLAG_* bits (zero for a mesh that was not cooked).
+    uint64_t vertexOffset;      // Start of the vertex blob (multiple of MESH_BLOB_ALIGNMENT).
+    uint64_t vertexBytes;       // vertexStride * vertexCount.
+    uint64_t indexOffset;       // Start of the index blob (multiple of MESH_BLOB_ALIGNMENT).
+    uint64_t indexBytes;        // indexSize * indexCount.
+};
+static_assert(sizeof(MeshFileHeader) == 64, "MeshFileHeader must match HEADER_FORMAT in scripts/make_mesh.py");
+
+// A mesh file mapped into memory. open() only validates the header, so loading costs one mmap regardless of
+// the mesh size; the pages are read by the OS when the blobs are first copied (sequential read-ahead is requested).
+class MeshFile
+{
+public:
+    // Maps and validates the file. Returns false (with a message) if it is missing or malformed.
+    bool open(const std::string& path);
+
+    // Unmaps the file. The blob pointers become invalid.
+    void close();
+
+    bool isOpen() const { return file.isOpen(); }
+
+    const MeshFileHeader& getHeader() const { return *header; }
+
+    // Vertex blob inside the mapping.
+    const void* getVertexData() const { return static_cast<const char*>(file.data()) + header->vertexOffset; }
+
+    // Index blob inside the mapping.
+    const void* getIndexData() const { return static_cast<const char*>(file.data()) + header->indexOffset; }
+
+    // VK_INDEX_TYPE_UINT16 or VK_INDEX_TYPE_UINT32, matching the index size.
+    VkIndexType getIndexType() const { return header->indexSize == 4 ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16; }
+
+    // Writes a mesh file with the given blobs (header.vertexOffset / vertexBytes / indexOffset / indexBytes are
+    // filled in; the other header fields are taken as they are). Returns false (with a message) on an I/O error.
+    static bool write(const std::string& path, MeshFileHeader header, const void* vertexData, const void* indexData);
+
+private:
+    MappedFile file;                                // Mapping of the whole file.
+    const MeshFileHeader* header = nullptr;         // Header at the start of the mapping.
+};
+
+#endif // MESH_FILE_H
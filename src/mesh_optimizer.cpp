@@ -0,0 +1,478 @@
+// Region: Includes
+// This section includes the mesh optimizer header and the standard headers it needs.
+#pragma region Includes
+
+// mesh_optimizer.cpp
+#include "mesh_optimizer.h"        // Include the header file for this module
+
+#include <algorithm>                // For std::stable_sort / std::min
+#include <cmath>                    // For std::pow / std::sqrt
+#include <cstring>                  // For memcmp / memcpy of vertices
+#include <limits>                   // For std::numeric_limits
+#include <vector>                   // For using std::vector dynamic arrays
+
+#pragma endregion
+
+// Region: Statistics
+// This section measures the vertex cache and vertex fetch behaviour of an index buffer.
+#pragma region Statistics
+
+const uint32_t FETCH_LINE_SIZE = 64;            // Bytes per cache line of the vertex buffer.
+const uint32_t FETCH_LINE_CACHE_SIZE = 64;      // Lines kept by the simulated fetch cache (4 KB).
+
+// Both caches are FIFOs tracked with timestamps: an entry is cached if it was inserted less than cacheSize
+// insertions ago.
+MeshStatistics analyzeMesh(const uint32_t* indices, size_t indexCount, size_t vertexCount, size_t vertexStride, uint32_t cacheSize)
+{
+    MeshStatistics statistics;
+    statistics.triangleCount = indexCount / 3;
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<bool> referenced(vertexCount, false);
+    uint32_t timestamp = cacheSize + 1;
+    size_t transformedVertices = 0;
+
+    size_t lineCount = (vertexCount * vertexStride + FETCH_LINE_SIZE - 1) / FETCH_LINE_SIZE;
+    std::vector<uint32_t> lineTime(lineCount, 0);
+    uint32_t lineTimestamp = FETCH_LINE_CACHE_SIZE + 1;
+    size_t fetchedBytes = 0;
+
+    for (size_t i = 0; i < statistics.triangleCount * 3; i++)
+    {
+        uint32_t vertex = indices[i];
+        if (!referenced[vertex])
+        {
+            referenced[vertex] = true;
+            statistics.vertexCount++;
+        }
+        if (timestamp - cacheTime[vertex] <= cacheSize)
+        {
+            continue; // Post-transform cache hit: no shading, no fetch.
+        }
+        cacheTime[vertex] = timestamp++;
+        transformedVertices++;
+
+        size_t firstLine = vertex * vertexStride / FETCH_LINE_SIZE;
+        size_t lastLine = (vertex * vertexStride + vertexStride - 1) / FETCH_LINE_SIZE;
+        for (size_t line = firstLine; line <= lastLine; line++)
+        {
+            if (lineTimestamp - lineTime[line] > FETCH_LINE_CACHE_SIZE)
+            {
+                lineTime[line] = lineTimestamp++;
+                fetchedBytes += FETCH_LINE_SIZE;
+            }
+        }
+    }
+
+    if (statistics.triangleCount > 0)
+    {
+        statistics.acmr = static_cast<float>(transformedVertices) / static_cast<float>(statistics.triangleCount);
+        statistics.atvr = static_cast<float>(transformedVertices) / static_cast<float>(statistics.vertexCount);
+        statistics.overfetch = static_cast<float>(fetchedBytes) / static_cast<float>(statistics.vertexCount * vertexStride);
+    }
+    return statistics;
+}
+
+#pragma endregion
+
+// Region: Vertex Cache
+// This section implements Forsyth's greedy triangle ordering for a 32-entry LRU cache.
+#pragma region Vertex Cache
+
+const uint32_t FORSYTH_CACHE_SIZE = 32;         // Modelled LRU cache size (larger than any real FIFO, so it adapts to all).
+const uint32_t FORSYTH_VALENCE_TABLE_SIZE = 32; // Remaining triangle counts with a precomputed score.
+
+// Score of a vertex from its cache position (-1 if not cached) and the number of triangles still using it.
+// Recently used vertices score high (the last triangle's slightly less, to avoid strips), and vertices with
+// few remaining triangles are boosted so they get finished and leave the cache.
+static float computeVertexScore(int cachePosition, uint32_t remainingTriangles)
+{
+    if (remainingTriangles == 0)
+    {
+        return -1.0f; // Fully used: never pulls triangles in.
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        if (cachePosition < 3)
+        {
+            score = 0.75f;
+        }
+        else
+        {
+            float scale = 1.0f / static_cast<float>(FORSYTH_CACHE_SIZE - 3);
+            score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scale, 1.5f);
+        }
+    }
+    return score + 2.0f / std::sqrt(static_cast<float>(remainingTriangles));
+}
+
+void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount)
+{
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    // Precomputed scores, indexed by cache position + 1 and by remaining triangle count.
+    float cacheScores[FORSYTH_CACHE_SIZE + 1];
+    float valenceScores[FORSYTH_VALENCE_TABLE_SIZE];
+    for (uint32_t i = 0; i <= FORSYTH_CACHE_SIZE; i++)
+    {
+        cacheScores[i] = computeVertexScore(static_cast<int>(i) - 1, 1) - computeVertexScore(-1, 1);
+    }
+    valenceScores[0] = -1.0f;
+    for (uint32_t i = 1; i < FORSYTH_VALENCE_TABLE_SIZE; i++)
+    {
+        valenceScores[i] = computeVertexScore(-1, i);
+    }
+    auto scoreOf = [&](int cachePosition, uint32_t remaining) {
+        if (remaining == 0)
+        {
+            return -1.0f;
+        }
+        float valence = remaining < FORSYTH_VALENCE_TABLE_SIZE ? valenceScores[remaining] : computeVertexScore(-1, remaining);
+        return cacheScores[cachePosition + 1] + valence;
+    };
+
+    // Triangles adjacent to each vertex; the live ones are kept at the front of each list.
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+    {
+        remaining[indices[i]]++;
+    }
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remaining[v];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+    {
+        adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<int> cachePositions(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        vertexScores[v] = scoreOf(-1, remaining[v]);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    size_t bestTriangle = 0;
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        const uint32_t* corners = indices + t * 3;
+        triangleScores[t] = vertexScores[corners[0]] + vertexScores[corners[1]] + vertexScores[corners[2]];
+        if (triangleScores[t] > triangleScores[bestTriangle])
+        {
+            bestTriangle = t;
+        }
+    }
+
+    std::vector<uint32_t> output(triangleCount * 3);
+    uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+    uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+    size_t cacheCount = 0;
+    size_t scanCursor = 0; // Fallback when no cached vertex has a live triangle (disconnected parts).
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+    {
+        if (bestTriangle == std::numeric_limits<size_t>::max())
+        {
+            while (emitted[scanCursor])
+            {
+                scanCursor++;
+            }
+            bestTriangle = scanCursor;
+        }
+
+        const uint32_t* corners = indices + bestTriangle * 3;
+        memcpy(&output[emittedCount * 3], corners, 3 * sizeof(uint32_t));
+        emitted[bestTriangle] = true;
+
+        // Remove the triangle from the live adjacency of its vertices.
+        for (int k = 0; k < 3; k++)
+        {
+            uint32_t vertex = corners[k];
+            uint32_t* list = &adjacency[adjacencyOffsets[vertex]];
+            for (uint32_t j = 0; j < remaining[vertex]; j++)
+            {
+                if (list[j] == bestTriangle)
+                {
+                    list[j] = list[remaining[vertex] - 1];
+                    remaining[vertex]--;
+                    break;
+                }
+            }
+        }
+
+        // The triangle's vertices move to the front of the LRU cache, the rest shift back.
+        size_t newCount = 0;
+        for (int k = 0; k < 3; k++)
+        {
+            if (std::find(newCache, newCache + newCount, corners[k]) == newCache + newCount)
+            {
+                newCache[newCount++] = corners[k];
+            }
+        }
+        for (size_t i = 0; i < cacheCount; i++)
+        {
+            uint32_t vertex = cache[i];
+            if (vertex != corners[0] && vertex != corners[1] && vertex != corners[2])
+            {
+                newCache[newCount++] = vertex;
+            }
+        }
+
+        // Rescore the touched vertices (evicted ones included), propagate to their live triangles, and pick the
+        // best of those triangles as the next one.
+        for (size_t i = 0; i < newCount; i++)
+        {
+            cachePositions[newCache[i]] = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+        }
+        bestTriangle = std::numeric_limits<size_t>::max();
+        float bestScore = -std::numeric_limits<float>::max();
+        for (size_t i = 0; i < newCount; i++)
+        {
+            uint32_t vertex = newCache[i];
+            float score = scoreOf(cachePositions[vertex], remaining[vertex]);
+            float delta = score - vertexScores[vertex];
+            vertexScores[vertex] = score;
+
+            const uint32_t* list = &adjacency[adjacencyOffsets[vertex]];
+            for (uint32_t j = 0; j < remaining[vertex]; j++)
+            {
+                uint32_t triangle = list[j];
+                triangleScores[triangle] += delta;
+                if (triangleScores[triangle] > bestScore)
+                {
+                    bestScore = triangleScores[triangle];
+                    bestTriangle = triangle;
+                }
+            }
+        }
+
+        cacheCount = std::min<size_t>(newCount, FORSYTH_CACHE_SIZE);
+        memcpy(cache, newCache, cacheCount * sizeof(uint32_t));
+    }
+
+    memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+}
+
+#pragma endregion
+
+// Region: Overdraw
+// This section reorders clusters of triangles so that geometry facing out of the mesh is drawn first.
+#pragma region Overdraw
+
+void optimizeOverdraw(uint32_t* indices, size_t indexCount, const float* positions, size_t positionStride, uint32_t positionComponents, size_t vertexCount)
+{
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    auto getPosition = [&](uint32_t vertex, float out[3]) {
+        const float* position = reinterpret_cast<const float*>(reinterpret_cast<const char*>(positions) + vertex * positionStride);
+        out[0] = position[0];
+        out[1] = position[1];
+        out[2] = positionComponents > 2 ? position[2] : 0.0f;
+    };
+
+    // A cluster starts wherever the cache-optimized order restarts: a triangle whose three vertices all miss.
+    // Reordering whole clusters therefore leaves the vertex cache efficiency unchanged.
+    std::vector<size_t> clusterStarts;
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    uint32_t timestamp = MESH_STATISTICS_CACHE_SIZE + 1;
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        int misses = 0;
+        for (int k = 0; k < 3; k++)
+        {
+            uint32_t vertex = indices[t * 3 + k];
+            if (timestamp - cacheTime[vertex] > MESH_STATISTICS_CACHE_SIZE)
+            {
+                cacheTime[vertex] = timestamp++;
+                misses++;
+            }
+        }
+        if (t == 0 || misses == 3)
+        {
+            clusterStarts.push_back(t);
+        }
+    }
+    clusterStarts.push_back(triangleCount);
+    size_t clusterCount = clusterStarts.size() - 1;
+
+    // Area-weighted centroid and summed normal of each cluster, and the centroid of the whole mesh.
+    std::vector<float> clusterCentroids(clusterCount * 3, 0.0f);
+    std::vector<float> clusterNormals(clusterCount * 3, 0.0f);
+    float meshCentroid[3] = {0.0f, 0.0f, 0.0f};
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusterCount; c++)
+    {
+        float* centroid = &clusterCentroids[c * 3];
+        float* normal = &clusterNormals[c * 3];
+        float clusterArea = 0.0f;
+        for (size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++)
+        {
+            float a[3], b[3], p[3];
+            float v0[3], v1[3], v2[3];
+            getPosition(indices[t * 3 + 0], v0);
+            getPosition(indices[t * 3 + 1], v1);
+            getPosition(indices[t * 3 + 2], v2);
+            for (int k = 0; k < 3; k++)
+            {
+                a[k] = v1[k] - v0[k];
+                b[k] = v2[k] - v0[k];
+            }
+            p[0] = a[1] * b[2] - a[2] * b[1];
+            p[1] = a[2] * b[0] - a[0] * b[2];
+            p[2] = a[0] * b[1] - a[1] * b[0];
+            float area = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+            for (int k = 0; k < 3; k++)
+            {
+                centroid[k] += (v0[k] + v1[k] + v2[k]) / 3.0f * area;
+                normal[k] += p[k];
+            }
+            clusterArea += area;
+        }
+        for (int k = 0; k < 3; k++)
+        {
+            meshCentroid[k] += centroid[k];
+            centroid[k] = clusterArea > 0.0f ? centroid[k] / clusterArea : 0.0f;
+        }
+        meshArea += clusterArea;
+    }
+    for (int k = 0; k < 3; k++)
+    {
+        meshCentroid[k] = meshArea > 0.0f ? meshCentroid[k] / meshArea : 0.0f;
+    }
+
+    // Sort key: how far the cluster lies along its own normal, measured from the mesh centroid. Clusters on
+    // the outside facing out are likely to occlude the rest, so they go first.
+    std::vector<float> sortKeys(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++)
+    {
+        const float* centroid = &clusterCentroids[c * 3];
+        const float* normal = &clusterNormals[c * 3];
+        float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        float dot = 0.0f;
+        for (int k = 0; k < 3; k++)
+        {
+            dot += (centroid[k] - meshCentroid[k]) * normal[k];
+        }
+        sortKeys[c] = length > 0.0f ? dot / length : 0.0f;
+    }
+
+    std::vector<size_t> clusterOrder(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++)
+    {
+        clusterOrder[c] = c;
+    }
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&](size_t a, size_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+    for (size_t c : clusterOrder)
+    {
+        output.insert(output.end(), indices + clusterStarts[c] * 3, indices + clusterStarts[c + 1] * 3);
+    }
+    memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+}
+
+#pragma endregion
+
+// Region: Vertex Fetch
+// This section deduplicates vertices and lays them out in the order the GPU reads them.
+#pragma region Vertex Fetch
+
+// FNV-1a over the vertex bytes.
+static uint64_t hashVertex(const unsigned char* vertex, size_t vertexStride)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < vertexStride; i++)
+    {
+        hash = (hash ^ vertex[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Open-addressing table of unique vertices (by new index). Unique vertices are moved down as they are found,
+// so the table can compare against the compacted copy.
+size_t deduplicateVertices(void* vertices, size_t vertexCount, size_t vertexStride, uint32_t* indices, size_t indexCount)
+{
+    unsigned char* bytes = static_cast<unsigned char*>(vertices);
+    size_t tableSize = 16;
+    while (tableSize < vertexCount * 2)
+    {
+        tableSize *= 2;
+    }
+    const uint32_t empty = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> table(tableSize, empty);
+    std::vector<uint32_t> remap(vertexCount);
+
+    size_t uniqueCount = 0;
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        const unsigned char* vertex = bytes + v * vertexStride;
+        size_t slot = static_cast<size_t>(hashVertex(vertex, vertexStride)) & (tableSize - 1);
+        while (table[slot] != empty && memcmp(bytes + table[slot] * vertexStride, vertex, vertexStride) != 0)
+        {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+
+        if (table[slot] == empty)
+        {
+            if (uniqueCount != v)
+            {
+                memcpy(bytes + uniqueCount * vertexStride, vertex, vertexStride);
+            }
+            table[slot] = static_cast<uint32_t>(uniqueCount++);
+        }
+        remap[v] = table[slot];
+    }
+
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        indices[i] = remap[indices[i]];
+    }
+    return uniqueCount;
+}
+
+size_t optimizeVertexFetch(void* vertices, size_t vertexCount, size_t vertexStride, uint32_t* indices, size_t indexCount)
+{
+    const uint32_t unused = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap(vertexCount, unused);
+    uint32_t nextVertex = 0;
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        uint32_t& target = remap[indices[i]];
+        if (target == unused)
+        {
+            target = nextVertex++;
+        }
+        indices[i] = target;
+    }
+
+    unsigned char* bytes = static_cast<unsigned char*>(vertices);
+    std::vector<unsigned char> reordered(static_cast<size_t>(nextVertex) * vertexStride);
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        if (remap[v] != unused)
+        {
+            memcpy(&reordered[remap[v] * vertexStride], bytes + v * vertexStride, vertexStride);
+        }
+    }
+    memcpy(bytes, reordered.data(), reordered.size());
+    return nextVertex;
+}
+
+#pragma endregion
@@ -0,0 +1,40 @@
+// mesh_optimizer.h
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <cstddef>                  // Necessary for size_t
+#include <cstdint>                  // Necessary for uint32_t
+
+// Size of the FIFO post-transform cache simulated by the statistics and the overdraw clustering.
+const uint32_t MESH_STATISTICS_CACHE_SIZE = 16;
+
+// Vertex cache and fetch efficiency of an index buffer.
+struct MeshStatistics
+{
+    size_t triangleCount = 0;
+    size_t vertexCount = 0;         // Vertices referenced by the indices.
+    float acmr = 0.0f;              // Average cache miss ratio: transformed vertices per triangle (0.5 to 3, lower is better).
+    float atvr = 0.0f;              // Average transformed to vertex ratio: transformed vertices per vertex (1 is ideal).
+    float overfetch = 0.0f;         // Bytes read from 64-byte lines per vertex byte (1 is ideal).
+};
+
+// Simulates a FIFO vertex cache and a cache of 64-byte lines of the vertex buffer over the index buffer.
+MeshStatistics analyzeMesh(const uint32_t* indices, size_t indexCount, size_t vertexCount, size_t vertexStride, uint32_t cacheSize = MESH_STATISTICS_CACHE_SIZE);
+
+// Merges vertices whose bytes are identical and rewrites the indices. Vertices are compacted in place;
+// returns the new vertex count.
+size_t deduplicateVertices(void* vertices, size_t vertexCount, size_t vertexStride, uint32_t* indices, size_t indexCount);
+
+// Reorders triangles for post-transform cache locality (Forsyth's linear-speed algorithm).
+void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+// Splits the cache-optimized triangle order into clusters at cache restarts and sorts the clusters so outward
+// facing ones are drawn first (Sander et al., "Fast Triangle Reordering"). Positions have 2 or 3 components;
+// 2D positions lie in the z = 0 plane. The vertex cache efficiency inside each cluster is kept.
+void optimizeOverdraw(uint32_t* indices, size_t indexCount, const float* positions, size_t positionStride, uint32_t positionComponents, size_t vertexCount);
+
+// Reorders vertices by first use in the index buffer and drops unreferenced ones, rewriting the indices.
+// Returns the new vertex count.
+size_t optimizeVertexFetch(void* vertices, size_t vertexCount, size_t vertexStride, uint32_t* indices, size_t indexCount);
+
+#endif // MESH_OPTIMIZER_H
@@ -0,0 +1,254 @@
+// Region: Includes
+// This section includes the pipeline builder header and the standard headers it needs.
+#pragma region Includes
+
+// pipeline_builder.cpp
+#include "pipeline_builder.h"      // Include the header file for this module
+#include "cpu_profiler.h"           // Include the scoped CPU zones (compiled out without ENABLE_CPU_PROFILER)
+
+#include <stdexcept>                // For standard exception handling (e.g., std::runtime_error)
+
+#pragma endregion
+
+// Region: Permutation Keys
+// This section serializes a permutation into the key used to share identical builds.
+#pragma region Permutation Keys
+
+// Appends the raw bytes of a value to a key.
+template <typename T>
+static void appendKey(std::string& key, const T& value)
+{
+    key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Serializes every field field by field (struct padding would make raw copies nondeterministic).
+std::string PipelinePermutation::key() const
+{
+    std::string result;
+
+    appendKey(result, static_cast<uint32_t>(vertexLayout.bindings.size()));
+    for (const auto& binding : vertexLayout.bindings)
+    {
+        appendKey(result, binding.binding);
+        appendKey(result, binding.stride);
+        appendKey(result, binding.inputRate);
+    }
+
+    appendKey(result, static_cast<uint32_t>(vertexLayout.attributes.size()));
+    for (const auto& attribute : vertexLayout.attributes)
+    {
+        appendKey(result, attribute.location);
+        appendKey(result, attribute.binding);
+        appendKey(result, attribute.format);
+        appendKey(result, attribute.offset);
+    }
+
+    appendKey(result, blendMode);
+    appendKey(result, cullMode);
+    appendKey(result, polygonMode);
+    appendKey(result, depthMode);
+    appendKey(result, subpass);
+
+    appendKey(result, static_cast<uint32_t>(specialization.entries.size()));
+    for (const auto& entry : specialization.entries)
+    {
+        appendKey(result, entry.constantID);
+        appendKey(result, entry.offset);
+        appendKey(result, static_cast<uint64_t>(entry.size));
+    }
+    result.append(reinterpret_cast<const char*>(specialization.data.data()), specialization.data.size());
+
+    return result;
+}
+
+#pragma endregion
+
+// Region: Public Interface
+// This section implements queuing permutations and releasing the pipelines.
+#pragma region Public Interface
+
+// Stores the shared state; nothing is compiled until build() is called.
+void PipelineBuilder::init(VkDevice logicalDevice, VkPipelineCache pipelineCache, ThreadPool* threads, const PipelineBase& pipelineBase)
+{
+    device = logicalDevice;
+    cache = pipelineCache;
+    threadPool = threads;
+    base = pipelineBase;
+}
+
+// Waits for every compilation and destroys the pipelines that were created.
+void PipelineBuilder::cleanup()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& pipeline : pipelines)
+    {
+        try
+        {
+            vkDestroyPipeline(device, pipeline.second.get(), nullptr);
+        }
+        catch (const std::exception&)
+        {
+            // The error was reported to whoever waited on the future; there is nothing to destroy.
+        }
+    }
+    pipelines.clear();
+}
+
+// Returns the future of an identical earlier request, or queues a new compilation.
+std::shared_future<VkPipeline> PipelineBuilder::build(const PipelinePermutation& permutation)
+{
+    std::string key = permutation.key();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto existing = pipelines.find(key);
+    if (existing != pipelines.end())
+    {
+        return existing->second;
+    }
+
+    std::shared_future<VkPipeline> pipeline = threadPool->submit([this, permutation]() { return compile(permutation); }).share();
+    pipelines.emplace(std::move(key), pipeline);
+    return pipeline;
+}
+
+// Queues the permutations in order, so the first ones finish first.
+std::vector<std::shared_future<VkPipeline>> PipelineBuilder::buildAll(const std::vector<PipelinePermutation>& permutations)
+{
+    std::vector<std::shared_future<VkPipeline>> result;
+    result.reserve(permutations.size());
+    for (const auto& permutation : permutations)
+    {
+        result.push_back(build(permutation));
+    }
+    return result;
+}
+
+// Number of distinct permutations requested so far.
+size_t PipelineBuilder::getPipelineCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return pipelines.size();
+}
+
+#pragma endregion
+
+// Region: Compilation
+// This section fills the fixed-function state of one permutation and creates the pipeline (runs on a worker).
+#pragma region Compilation
+
+// Creates the graphics pipeline of a permutation through the shared cache.
+VkPipeline PipelineBuilder::compile(const PipelinePermutation& permutation) const
+{
+    PROFILE_FUNCTION(); // Runs on the pipeline worker threads.
+
+    // A depth-only pipeline has no fragment stage and writes no color.
+    bool depthOnly = permutation.depthMode == DepthMode::DepthOnly;
+
+    // The same specialization data is handed to both stages.
+    VkSpecializationInfo specializationInfo{};
+    specializationInfo.mapEntryCount = static_cast<uint32_t>(permutation.specialization.entries.size());
+    specializationInfo.pMapEntries = permutation.specialization.entries.data();
+    specializationInfo.dataSize = permutation.specialization.data.size();
+    specializationInfo.pData = permutation.specialization.data.data();
+    const VkSpecializationInfo* specialization = specializationInfo.mapEntryCount > 0 ? &specializationInfo : nullptr;
+
+    VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStages[0].module = base.vertexShader;
+    shaderStages[0].pName = "main";
+    shaderStages[0].pSpecializationInfo = specialization;
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = base.fragmentShader;
+    shaderStages[1].pName = "main";
+    shaderStages[1].pSpecializationInfo = specialization;
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(permutation.vertexLayout.bindings.size());
+    vertexInputInfo.pVertexBindingDescriptions = permutation.vertexLayout.bindings.data();
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(permutation.vertexLayout.attributes.size());
+    vertexInputInfo.pVertexAttributeDescriptions = permutation.vertexLayout.attributes.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    // Viewport and scissor are dynamic, so the pipelines survive swap chain recreation.
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    rasterizer.polygonMode = permutation.polygonMode;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = permutation.cullMode;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.depthBiasEnable = VK_FALSE;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.sampleShadingEnable = VK_FALSE;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = permutation.depthMode == DepthMode::Disabled ? VK_FALSE : VK_TRUE;
+    depthStencil.depthWriteEnable = permutation.depthMode == DepthMode::TestAndWrite || depthOnly ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = permutation.depthMode == DepthMode::TestOnly ? VK_COMPARE_OP_LESS_OR_EQUAL : VK_COMPARE_OP_LESS;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
+
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = permutation.blendMode == BlendMode::Opaque ? VK_FALSE : VK_TRUE;
+    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor = permutation.blendMode == BlendMode::Additive ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.logicOpEnable = VK_FALSE;
+    colorBlending.attachmentCount = depthOnly ? 0 : 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = depthOnly ? 1 : 2;
+    pipelineInfo.pStages = shaderStages;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = base.layout;
+    pipelineInfo.renderPass = base.renderPass;
+    pipelineInfo.subpass = permutation.subpass;
+
+    VkPipeline pipeline;
+    if (vkCreateGraphicsPipelines(device, cache, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create graphics pipeline permutation!");
+    }
+    return pipeline;
+}
+
+#pragma endregion
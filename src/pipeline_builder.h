@@ -0,0 +1,121 @@
+// pipeline_builder.h
+#ifndef PIPELINE_BUILDER_H
+#define PIPELINE_BUILDER_H
+
+#include "thread_pool.h"           // Pipelines are compiled on the worker threads
+
+#include <vulkan/vulkan.h>          // Vulkan types (VkPipeline, VkPipelineLayout, ...)
+#include <cstddef>                  // Necessary for size_t
+#include <cstdint>                  // Necessary for uint32_t / uint8_t
+#include <cstring>                  // For memcpy of specialization values
+#include <future>                   // For std::shared_future returned by build
+#include <map>                      // For the permutation key -> pipeline table
+#include <mutex>                    // For guarding the pipeline table
+#include <string>                   // For the permutation keys
+#include <vector>                   // For using std::vector dynamic arrays
+
+// Color blending presets for the single color attachment.
+enum class BlendMode
+{
+    Opaque,                         // Blending disabled.
+    Alpha,                          // src * srcAlpha + dst * (1 - srcAlpha).
+    Additive                        // src * srcAlpha + dst.
+};
+
+// Depth test presets. Every preset compiles for a subpass that has a depth attachment; Disabled also fits one without.
+enum class DepthMode
+{
+    Disabled,                       // No depth test or write.
+    TestAndWrite,                   // LESS test, writes depth.
+    TestOnly,                       // LESS_OR_EQUAL test without writes (after a depth pre-pass, or for blended geometry).
+    DepthOnly                       // LESS test and write, no fragment shader and no color attachment (the depth pre-pass).
+};
+
+// Vertex buffer bindings and attributes consumed by the vertex shader.
+struct VertexLayout
+{
+    std::vector<VkVertexInputBindingDescription> bindings;
+    std::vector<VkVertexInputAttributeDescription> attributes;
+};
+
+// Specialization constant values, applied to every shader stage (IDs a stage does not declare are ignored).
+struct SpecializationConstants
+{
+    std::vector<VkSpecializationMapEntry> entries;
+    std::vector<uint8_t> data;
+
+    // Appends the value of the constant declared with layout(constant_id = constantID).
+    template <typename T>
+    SpecializationConstants& set(uint32_t constantID, const T& value)
+    {
+        VkSpecializationMapEntry entry{};
+        entry.constantID = constantID;
+        entry.offset = static_cast<uint32_t>(data.size());
+        entry.size = sizeof(T);
+        entries.push_back(entry);
+
+        data.resize(data.size() + sizeof(T));
+        memcpy(data.data() + entry.offset, &value, sizeof(T));
+        return *this;
+    }
+};
+
+// The state that differs between the variants of a pipeline.
+struct PipelinePermutation
+{
+    VertexLayout vertexLayout;
+    BlendMode blendMode = BlendMode::Opaque;
+    VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+    VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;   // LINE and POINT need the fillModeNonSolid feature.
+    DepthMode depthMode = DepthMode::Disabled;
+    uint32_t subpass = 0;                               // Subpass of PipelineBase::renderPass the pipeline is used in.
+    SpecializationConstants specialization;
+
+    // Byte string identifying the permutation (equal keys build the same pipeline).
+    std::string key() const;
+};
+
+// The state shared by every permutation built by one PipelineBuilder.
+struct PipelineBase
+{
+    VkShaderModule vertexShader = VK_NULL_HANDLE;
+    VkShaderModule fragmentShader = VK_NULL_HANDLE;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+};
+
+// Compiles graphics pipeline permutations on a thread pool.
+// Every build goes through the same VkPipelineCache (internally synchronized), and requesting a permutation
+// that was already requested returns the existing future instead of compiling it again. The builder owns the
+// pipelines; the shader modules and layout in PipelineBase must stay alive until cleanup().
+class PipelineBuilder
+{
+public:
+    // threads runs the compilations; it should not be a pool the render loop waits on.
+    void init(VkDevice device, VkPipelineCache pipelineCache, ThreadPool* threads, const PipelineBase& base);
+
+    // Waits for the compilations still running and destroys every pipeline.
+    void cleanup();
+
+    // Queues a permutation (in submission order) and returns a future for its pipeline.
+    // A failed compilation rethrows its std::runtime_error from get().
+    std::shared_future<VkPipeline> build(const PipelinePermutation& permutation);
+
+    // Queues several permutations; the futures are returned in the same order.
+    std::vector<std::shared_future<VkPipeline>> buildAll(const std::vector<PipelinePermutation>& permutations);
+
+    // Number of distinct permutations requested so far.
+    size_t getPipelineCount();
+
+private:
+    VkPipeline compile(const PipelinePermutation& permutation) const;
+
+    VkDevice device = VK_NULL_HANDLE;               // Logical device owning the pipelines.
+    VkPipelineCache cache = VK_NULL_HANDLE;         // Cache shared by every compilation.
+    ThreadPool* threadPool = nullptr;               // Workers running compile().
+    PipelineBase base;                              // Shaders, layout and render pass of every permutation.
+    std::map<std::string, std::shared_future<VkPipeline>> pipelines; // Permutation key -> pipeline being built or built.
+    std::mutex mutex;                               // Guards pipelines.
+};
+
+#endif // PIPELINE_BUILDER_H
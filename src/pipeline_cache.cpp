@@ -0,0 +1,165 @@
+// Region: Includes
+// This section includes the pipeline cache header and the standard headers it needs.
+#pragma region Includes
+
+// pipeline_cache.cpp
+#include "pipeline_cache.h"        // Include the header file for this module
+
+#include <cstring>                  // For memcmp on the cache UUID
+#include <filesystem>               // For the atomic rename of the saved file
+#include <fstream>                  // For reading and writing the cache file
+#include <iostream>                 // For reporting load and save results
+#include <stdexcept>                // For standard exception handling (e.g., std::runtime_error)
+#include <vector>                   // For using std::vector dynamic arrays
+
+#pragma endregion
+
+// Region: Public Interface
+// This section implements loading, validating and saving the pipeline cache.
+#pragma region Public Interface
+
+// Loads the cache file and creates the pipeline cache.
+void PipelineCache::init(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, const std::string& cachePath)
+{
+    device = logicalDevice;
+    path = cachePath;
+    warm = false;
+    savedSize = 0;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    // Read the whole blob; a missing file simply means a cold start.
+    std::vector<char> data;
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    if (file.is_open())
+    {
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(data.data(), data.size());
+        if (!file)
+        {
+            data.clear();
+        }
+    }
+
+    std::string reason;
+    if (data.empty())
+    {
+        std::cout << "Pipeline cache: no cache at " << path << ", starting cold" << std::endl;
+    }
+    else if (!validateHeader(data.data(), data.size(), properties, reason))
+    {
+        std::cout << "Pipeline cache: ignoring " << path << " (" << reason << ")" << std::endl;
+        data.clear();
+    }
+    else
+    {
+        std::cout << "Pipeline cache: loaded " << data.size() << " bytes from " << path << std::endl;
+        warm = true;
+        savedSize = data.size();
+    }
+
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (vkCreatePipelineCache(device, &createInfo, nullptr, &cache) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create pipeline cache!");
+    }
+}
+
+// Saves the cache one last time and destroys it.
+void PipelineCache::cleanup()
+{
+    save();
+    vkDestroyPipelineCache(device, cache, nullptr);
+    cache = VK_NULL_HANDLE;
+}
+
+// Writes the cache to a temporary file and renames it over the previous one.
+bool PipelineCache::save()
+{
+    size_t size = 0;
+    if (vkGetPipelineCacheData(device, cache, &size, nullptr) != VK_SUCCESS || size <= savedSize)
+    {
+        return false; // Nothing new since the last save (the cache only grows).
+    }
+
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(device, cache, &size, data.data()) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), size);
+        file.flush();
+        if (!file)
+        {
+            std::cerr << "Pipeline cache: failed to write " << temporaryPath << std::endl;
+            return false;
+        }
+    }
+
+    // rename replaces the destination in one step, so readers see either the old or the new cache.
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+    {
+        std::cerr << "Pipeline cache: failed to replace " << path << " (" << error.message() << ")" << std::endl;
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    savedSize = size;
+    std::cout << "Pipeline cache: saved " << size << " bytes to " << path << std::endl;
+    return true;
+}
+
+#pragma endregion
+
+// Region: Validation
+// This section checks that a cache blob was produced by the current GPU and driver.
+#pragma region Validation
+
+// Checks the VkPipelineCacheHeaderVersionOne at the start of the blob.
+bool PipelineCache::validateHeader(const char* data, size_t size, const VkPhysicalDeviceProperties& properties, std::string& reason) const
+{
+    VkPipelineCacheHeaderVersionOne header;
+    if (size < sizeof(header))
+    {
+        reason = "file too small";
+        return false;
+    }
+    memcpy(&header, data, sizeof(header)); // The blob has no alignment guarantee.
+
+    if (header.headerSize < sizeof(header) || header.headerSize > size)
+    {
+        reason = "bad header size";
+        return false;
+    }
+    if (header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+    {
+        reason = "unknown header version";
+        return false;
+    }
+    if (header.vendorID != properties.vendorID || header.deviceID != properties.deviceID)
+    {
+        reason = "created on a different GPU";
+        return false;
+    }
+    if (memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        reason = "created by a different driver version";
+        return false;
+    }
+
+    return true;
+}
+
+#pragma endregion
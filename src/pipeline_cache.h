@@ -0,0 +1,41 @@
+// pipeline_cache.h
+#ifndef PIPELINE_CACHE_H
+#define PIPELINE_CACHE_H
+
+#include <vulkan/vulkan.h>          // Vulkan types (VkPipelineCache, VkPhysicalDeviceProperties, ...)
+#include <cstddef>                  // Necessary for size_t
+#include <string>                   // For the cache file path
+
+// A VkPipelineCache persisted to disk between launches.
+// The blob is only fed back to the driver when its header matches the current GPU (vendor, device and cache UUID),
+// because a blob from another driver or device is useless at best. Saving writes a temporary file and renames it
+// over the old one, so a crash while saving never leaves a truncated cache behind.
+class PipelineCache
+{
+public:
+    // Loads and validates the cache file (if any) and creates the VkPipelineCache from it.
+    void init(VkPhysicalDevice physicalDevice, VkDevice device, const std::string& path);
+
+    // Saves the cache and destroys it.
+    void cleanup();
+
+    // Writes the cache to disk if its contents grew since the last save. Returns true if the file was written.
+    bool save();
+
+    // Cache handle to pass to vkCreate*Pipelines (internally synchronized, may be shared between threads).
+    VkPipelineCache getHandle() const { return cache; }
+
+    // True if a valid blob from a previous run was loaded (pipeline creation should hit the cache).
+    bool isWarm() const { return warm; }
+
+private:
+    bool validateHeader(const char* data, size_t size, const VkPhysicalDeviceProperties& properties, std::string& reason) const;
+
+    VkDevice device = VK_NULL_HANDLE;               // Logical device owning the cache.
+    VkPipelineCache cache = VK_NULL_HANDLE;         // The pipeline cache.
+    std::string path;                               // Cache file path.
+    size_t savedSize = 0;                           // Size of the data written by the last save (or loaded at init).
+    bool warm = false;                              // True when the loaded blob was accepted.
+};
+
+#endif // PIPELINE_CACHE_H
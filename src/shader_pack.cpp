@@ -0,0 +1,88 @@
+// Region: Includes
+// This section includes the shader pack header and the standard headers it needs.
+#pragma region Includes
+
+// shader_pack.cpp
+#include "shader_pack.h"           // Include the header file for this module
+
+#include <cstring>                  // For memcmp / strncmp on the magic and entry names
+#include <iostream>                 // For reporting malformed packs
+
+#pragma endregion
+
+// Region: Public Interface
+// This section implements validating the pack and looking up its entries.
+#pragma region Public Interface
+
+// Maps the pack and checks that every entry lies inside the file.
+bool ShaderPack::open(const std::string& path)
+{
+    close();
+
+    if (!file.open(path))
+    {
+        return false; // No pack is not an error: the embedded shaders are used instead.
+    }
+
+    const char* base = static_cast<const char*>(file.data());
+    size_t fileSize = file.size();
+
+    const Header* header = reinterpret_cast<const Header*>(base); // mmap returns page-aligned memory.
+    if (fileSize < sizeof(Header) || memcmp(header->magic, "SPK1", 4) != 0)
+    {
+        std::cerr << "Shader pack: " << path << " is not a shader pack" << std::endl;
+        close();
+        return false;
+    }
+
+    if (header->entryCount > (fileSize - sizeof(Header)) / sizeof(Entry))
+    {
+        std::cerr << "Shader pack: " << path << " has a truncated entry table" << std::endl;
+        close();
+        return false;
+    }
+
+    entries = reinterpret_cast<const Entry*>(base + sizeof(Header));
+    entryCount = header->entryCount;
+
+    for (uint32_t i = 0; i < entryCount; i++)
+    {
+        const Entry& entry = entries[i];
+        bool aligned = entry.offset % 4 == 0 && entry.size % 4 == 0;
+        bool inside = entry.offset <= fileSize && entry.size <= fileSize - entry.offset;
+        if (!aligned || !inside || memchr(entry.name, '\0', sizeof(entry.name)) == nullptr)
+        {
+            std::cerr << "Shader pack: " << path << " has a malformed entry " << i << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    std::cout << "Shader pack: mapped " << entryCount << " shaders from " << path << std::endl;
+    return true;
+}
+
+// Unmaps the pack.
+void ShaderPack::close()
+{
+    file.close();
+    entries = nullptr;
+    entryCount = 0;
+}
+
+// Returns a pointer into the mapping for the named shader.
+bool ShaderPack::find(const char* name, const uint32_t*& code, size_t& size) const
+{
+    for (uint32_t i = 0; i < entryCount; i++)
+    {
+        if (strncmp(entries[i].name, name, sizeof(entries[i].name)) == 0)
+        {
+            code = reinterpret_cast<const uint32_t*>(static_cast<const char*>(file.data()) + entries[i].offset);
+            size = entries[i].size;
+            return true;
+        }
+    }
+    return false;
+}
+
+#pragma endregion
@@ -0,0 +1,50 @@
+// shader_pack.h
+#ifndef SHADER_PACK_H
+#define SHADER_PACK_H
+
+#include "mapped_file.h"           // The pack is used directly from a memory mapping
+
+#include <cstddef>                  // Necessary for size_t
+#include <cstdint>                  // Necessary for uint32_t
+#include <string>                   // For the pack path and entry names
+
+// An external pack of SPIR-V blobs, memory mapped and handed to vkCreateShaderModule without any copy.
+// Layout (little endian, written by scripts/pack_shaders.py):
+//   header   { char magic[4] = "SPK1"; uint32_t entryCount; }
+//   entries  { char name[56]; uint32_t offset; uint32_t size; } x entryCount
+//   blobs    SPIR-V words, each blob starting on a 4-byte boundary
+// Names are the shader paths relative to shaders/ (e.g. "1_triangle/shader.vert.spv").
+class ShaderPack
+{
+public:
+    // Maps and validates the pack. Returns false if the file is missing or malformed.
+    bool open(const std::string& path);
+
+    // Unmaps the pack. Code pointers returned by find() become invalid.
+    void close();
+
+    // Looks up a shader by name. code points into the mapping and stays valid until close().
+    bool find(const char* name, const uint32_t*& code, size_t& size) const;
+
+    bool isOpen() const { return file.isOpen(); }
+
+private:
+    struct Header
+    {
+        char magic[4];
+        uint32_t entryCount;
+    };
+
+    struct Entry
+    {
+        char name[56];
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    MappedFile file;                                // Mapping of the whole pack.
+    const Entry* entries = nullptr;                 // Entry table (inside the mapping).
+    uint32_t entryCount = 0;                        // Number of entries.
+};
+
+#endif // SHADER_PACK_H
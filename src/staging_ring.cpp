@@ -0,0 +1,104 @@
+// Region: Includes
+// This section includes the staging ring header and the standard headers it needs.
+#pragma region Includes
+
+// staging_ring.cpp
+#include "staging_ring.h"          // Include the header file for this module
+
+#include <stdexcept>                // For standard exception handling (e.g., std::runtime_error)
+
+#pragma endregion
+
+// Region: Public Interface
+// This section implements creation of the ring buffer, allocation with wraparound and release of finished spans.
+#pragma region Public Interface
+
+// Creates and maps the ring buffer.
+void StagingRing::init(VkDevice logicalDevice, DeviceMemoryAllocator* memoryAllocator, VkDeviceSize sizeBytes)
+{
+    device = logicalDevice;
+    allocator = memoryAllocator;
+    size = sizeBytes;
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT; // Only ever read by copy commands.
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create staging ring buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+    allocation = allocator->allocate(memRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, MemoryTag::Staging);
+    vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset);
+
+    head = 0;
+    tail = 0;
+    spans.clear();
+}
+
+// Destroys the ring buffer.
+void StagingRing::cleanup()
+{
+    vkDestroyBuffer(device, buffer, nullptr);
+    allocator->free(allocation);
+    buffer = VK_NULL_HANDLE;
+}
+
+// Bump-allocates a slice, wrapping around to the start of the buffer when the end is too small.
+bool StagingRing::allocate(VkDeviceSize sliceSize, VkDeviceSize alignment, uint64_t ticket, StagingSlice& slice)
+{
+    VkDeviceSize offset = (head + alignment - 1) & ~(alignment - 1); // Align the head (alignment is a power of two).
+    bool wrapped = head < tail; // The free space is [head, tail); otherwise it is [head, size) and [0, tail).
+
+    if (!wrapped && offset + sliceSize > size)
+    {
+        offset = 0; // Skip the end of the buffer; those bytes come back when the tail wraps too.
+        wrapped = true;
+    }
+    if (wrapped && offset + sliceSize >= tail)
+    {
+        return false; // Would reach the oldest span still in use (head == tail is kept for an empty ring).
+    }
+
+    // Consecutive allocations of one batch extend its span.
+    if (!spans.empty() && spans.back().ticket == ticket && spans.back().end <= offset)
+    {
+        spans.back().end = offset + sliceSize;
+    }
+    else
+    {
+        spans.push_back({ offset, offset + sliceSize, ticket });
+    }
+    head = offset + sliceSize;
+
+    slice.buffer = buffer;
+    slice.offset = offset;
+    slice.mappedData = static_cast<char*>(allocation.mappedData) + offset;
+    return true;
+}
+
+// Frees the spans of the finished batches and moves the tail to the oldest span left.
+void StagingRing::release(uint64_t completedTicket)
+{
+    while (!spans.empty() && spans.front().ticket <= completedTicket)
+    {
+        spans.pop_front();
+    }
+
+    if (spans.empty())
+    {
+        head = 0; // Nothing in flight: start over with the whole buffer free.
+        tail = 0;
+    }
+    else
+    {
+        tail = spans.front().begin;
+    }
+}
+
+#pragma endregion
@@ -0,0 +1,64 @@
+// staging_ring.h
+#ifndef STAGING_RING_H
+#define STAGING_RING_H
+
+#include "memory_allocator.h"       // The ring buffer memory comes from the sub-allocator
+#include <vulkan/vulkan.h>          // Vulkan types (VkBuffer, VkDeviceSize, ...)
+#include <cstdint>                  // Necessary for uint64_t
+#include <deque>                    // For the spans still in use
+
+// A range of the staging ring handed out for one upload.
+struct StagingSlice
+{
+    VkBuffer buffer = VK_NULL_HANDLE;   // The ring buffer (use as srcBuffer of vkCmdCopyBuffer).
+    VkDeviceSize offset = 0;            // Offset of the slice inside the ring buffer (use as srcOffset).
+    void* mappedData = nullptr;         // Host pointer to the first byte of the slice.
+};
+
+// One persistently mapped, host-visible staging buffer used as a ring.
+// Allocation is a bump of the head pointer; when the rest of the buffer is too small the head wraps around to the
+// start. Every allocation is tagged with the ticket of the batch that reads it, and consecutive allocations of the
+// same batch form one span. Spans are released in order once their ticket has completed, which moves the tail and
+// makes their bytes available again; the head never overtakes the tail, so no byte still read by the GPU is reused.
+class StagingRing
+{
+public:
+    // Creates the ring buffer and maps it.
+    void init(VkDevice device, DeviceMemoryAllocator* allocator, VkDeviceSize sizeBytes);
+
+    // Destroys the ring buffer and returns its memory to the allocator.
+    void cleanup();
+
+    // Allocates `size` contiguous bytes read by the batch identified by ticket.
+    // Returns false when the free space does not hold them; the caller waits for getOldestTicket() and retries.
+    bool allocate(VkDeviceSize size, VkDeviceSize alignment, uint64_t ticket, StagingSlice& slice);
+
+    // Releases the spans of every batch up to completedTicket.
+    void release(uint64_t completedTicket);
+
+    // Ticket of the oldest batch still reading from the ring, 0 if the ring is empty.
+    uint64_t getOldestTicket() const { return spans.empty() ? 0 : spans.front().ticket; }
+
+    // Capacity in bytes (the largest upload the ring can hold).
+    VkDeviceSize getSize() const { return size; }
+
+private:
+    // Bytes [begin, end) of the ring read by one batch.
+    struct StagingSpan
+    {
+        VkDeviceSize begin = 0;
+        VkDeviceSize end = 0;
+        uint64_t ticket = 0;
+    };
+
+    VkDevice device = VK_NULL_HANDLE;                   // Logical device.
+    DeviceMemoryAllocator* allocator = nullptr;         // Allocator the ring memory was taken from.
+    VkBuffer buffer = VK_NULL_HANDLE;                   // The ring buffer.
+    MemoryAllocation allocation = {};                   // Memory backing the ring buffer (persistently mapped).
+    VkDeviceSize size = 0;                              // Size of the ring buffer.
+    VkDeviceSize head = 0;                              // Next free byte.
+    VkDeviceSize tail = 0;                              // First byte still in use (start of the oldest span).
+    std::deque<StagingSpan> spans;                      // Spans still read by the GPU, oldest first.
+};
+
+#endif // STAGING_RING_H
@@ -0,0 +1,73 @@
+// Region: Includes
+// This section includes the thread pool header.
+#pragma region Includes
+
+// thread_pool.cpp
+#include "thread_pool.h"           // Include the header file for this module
+
+#include <algorithm>                // For std::max
+
+#pragma endregion
+
+// Region: Public Interface
+// This section implements starting, stopping and running the worker threads.
+#pragma region Public Interface
+
+// Joins the workers if the owner forgot to call cleanup().
+ThreadPool::~ThreadPool()
+{
+    cleanup();
+}
+
+// Starts the worker threads.
+void ThreadPool::init(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max<size_t>(1, std::thread::hardware_concurrency()); // hardware_concurrency may report 0.
+    }
+
+    stopping = false;
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+// Lets the workers drain the queue, then joins them.
+void ThreadPool::cleanup()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    workers.clear();
+}
+
+// Runs queued tasks until the pool is stopped and the queue is empty.
+void ThreadPool::workerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+            {
+                return; // Stopping and nothing left to do.
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task(); // Exceptions are captured by the packaged_task and rethrown by future::get().
+    }
+}
+
+#pragma endregion
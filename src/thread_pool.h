@@ -0,0 +1,57 @@
+// thread_pool.h
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>       // For waking up idle workers
+#include <cstddef>                  // Necessary for size_t
+#include <functional>               // For std::function holding the queued tasks
+#include <future>                   // For std::future / std::packaged_task returned by submit
+#include <memory>                   // For std::shared_ptr owning the packaged tasks
+#include <mutex>                    // For guarding the task queue
+#include <queue>                    // For the FIFO task queue
+#include <thread>                   // For the worker threads
+#include <type_traits>              // For std::invoke_result_t
+#include <vector>                   // For using std::vector dynamic arrays
+
+// Fixed-size pool of worker threads consuming a FIFO task queue.
+// submit() returns a std::future, so callers can wait for results and receive exceptions thrown by the task.
+class ThreadPool
+{
+public:
+    ~ThreadPool(); // Joins the workers if cleanup() was not called.
+
+    // Starts threadCount workers (0 = one per hardware thread).
+    void init(size_t threadCount = 0);
+
+    // Finishes the queued tasks and joins every worker.
+    void cleanup();
+
+    // Queues a callable and returns a future for its result.
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& task)
+    {
+        using Result = std::invoke_result_t<F>;
+        auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task)); // std::function needs a copyable callable.
+        std::future<Result> result = packagedTask->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([packagedTask]() { (*packagedTask)(); });
+        }
+        wakeUp.notify_one();
+        return result;
+    }
+
+    // Number of worker threads.
+    size_t getThreadCount() const { return workers.size(); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;               // Worker threads.
+    std::queue<std::function<void()>> tasks;        // Tasks waiting for a worker.
+    std::mutex mutex;                               // Guards tasks and stopping.
+    std::condition_variable wakeUp;                 // Signaled when a task is queued or the pool stops.
+    bool stopping = false;                          // Set by cleanup() to let the workers exit.
+};
+
+#endif // THREAD_POOL_H
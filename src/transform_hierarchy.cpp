@@ -0,0 +1,206 @@
+// Region: Includes
+// This section includes the transform hierarchy header and the SIMD intrinsics it uses.
+#pragma region Includes
+
+// transform_hierarchy.cpp
+#include "transform_hierarchy.h"   // Include the header file for this module
+
+#include <algorithm>                // For std::stable_sort / std::fill
+#include <cstring>                  // For memcpy of matrices
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define TRANSFORM_HIERARCHY_SSE
+    #include <xmmintrin.h>          // SSE intrinsics
+#endif
+
+#pragma endregion
+
+// Region: Matrix Batches
+// This section multiplies the dirty nodes of one depth level by their parents' world matrices.
+#pragma region Matrix Batches
+
+// out = a * b for column-major matrices. Each output column is a combination of the columns of a weighted by
+// one column of b, so a column is 4 multiplies and 3 adds on 4-wide registers.
+static inline void multiplyMatrix(const TransformMatrix& a, const TransformMatrix& b, TransformMatrix& out)
+{
+#ifdef TRANSFORM_HIERARCHY_SSE
+    __m128 a0 = _mm_load_ps(a.m + 0);
+    __m128 a1 = _mm_load_ps(a.m + 4);
+    __m128 a2 = _mm_load_ps(a.m + 8);
+    __m128 a3 = _mm_load_ps(a.m + 12);
+    for (int column = 0; column < 4; column++)
+    {
+        const float* weights = b.m + column * 4;
+        __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, _mm_set1_ps(weights[0])), _mm_mul_ps(a1, _mm_set1_ps(weights[1]))),
+                                   _mm_add_ps(_mm_mul_ps(a2, _mm_set1_ps(weights[2])), _mm_mul_ps(a3, _mm_set1_ps(weights[3]))));
+        _mm_store_ps(out.m + column * 4, result);
+    }
+#else
+    for (int column = 0; column < 4; column++)
+    {
+        for (int row = 0; row < 4; row++)
+        {
+            out.m[column * 4 + row] = a.m[0 * 4 + row] * b.m[column * 4 + 0] + a.m[1 * 4 + row] * b.m[column * 4 + 1]
+                                    + a.m[2 * 4 + row] * b.m[column * 4 + 2] + a.m[3 * 4 + row] * b.m[column * 4 + 3];
+        }
+    }
+#endif
+}
+
+// All slots of a batch share one depth, so none of them is the parent of another: the loop has no dependencies
+// and the parents' world matrices are final.
+static void updateBatch(const uint32_t* slots, size_t count, const uint32_t* parentSlots, const TransformMatrix* locals, TransformMatrix* worlds)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t slot = slots[i];
+        uint32_t parent = parentSlots[slot];
+        if (parent == TRANSFORM_NO_PARENT)
+        {
+            worlds[slot] = locals[slot];
+        }
+        else
+        {
+            multiplyMatrix(worlds[parent], locals[slot], worlds[slot]);
+        }
+    }
+}
+
+#pragma endregion
+
+// Region: Public Interface
+// This section adds nodes, records changes and runs the incremental update.
+#pragma region Public Interface
+
+// Appending keeps parents before children; only a node shallower than the last one breaks the depth order.
+uint32_t TransformHierarchy::addNode(uint32_t parent, const float local[16])
+{
+    uint32_t slot = static_cast<uint32_t>(parentSlots.size());
+    uint32_t node = static_cast<uint32_t>(slotOfNode.size());
+    uint32_t parentSlot = parent == TRANSFORM_NO_PARENT ? TRANSFORM_NO_PARENT : slotOfNode[parent];
+    uint32_t depth = parentSlot == TRANSFORM_NO_PARENT ? 0 : depths[parentSlot] + 1;
+
+    if (!depths.empty() && depth < depths.back())
+    {
+        needsSort = true;
+    }
+
+    TransformMatrix matrix;
+    memcpy(matrix.m, local, sizeof(matrix.m));
+    parentSlots.push_back(parentSlot);
+    depths.push_back(depth);
+    locals.push_back(matrix);
+    worlds.push_back(matrix);
+    dirty.push_back(1);
+    nodeOfSlot.push_back(node);
+    slotOfNode.push_back(slot);
+    anyDirty = true;
+    return node;
+}
+
+void TransformHierarchy::setLocal(uint32_t node, const float local[16])
+{
+    uint32_t slot = slotOfNode[node];
+    memcpy(locals[slot].m, local, sizeof(locals[slot].m));
+    dirty[slot] = 1;
+    anyDirty = true;
+}
+
+// Stable reorder of every array by depth, remapping the parent slots and the handle table.
+void TransformHierarchy::sortByDepth()
+{
+    size_t count = parentSlots.size();
+    std::vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return depths[a] < depths[b]; });
+
+    std::vector<uint32_t> newSlotOfOldSlot(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        newSlotOfOldSlot[order[i]] = static_cast<uint32_t>(i);
+    }
+
+    std::vector<uint32_t> sortedParents(count), sortedDepths(count), sortedNodes(count);
+    std::vector<TransformMatrix> sortedLocals(count), sortedWorlds(count);
+    std::vector<uint8_t> sortedDirty(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t old = order[i];
+        sortedParents[i] = parentSlots[old] == TRANSFORM_NO_PARENT ? TRANSFORM_NO_PARENT : newSlotOfOldSlot[parentSlots[old]];
+        sortedDepths[i] = depths[old];
+        sortedLocals[i] = locals[old];
+        sortedWorlds[i] = worlds[old];
+        sortedDirty[i] = dirty[old];
+        sortedNodes[i] = nodeOfSlot[old];
+        slotOfNode[nodeOfSlot[old]] = static_cast<uint32_t>(i);
+    }
+
+    parentSlots.swap(sortedParents);
+    depths.swap(sortedDepths);
+    locals.swap(sortedLocals);
+    worlds.swap(sortedWorlds);
+    dirty.swap(sortedDirty);
+    nodeOfSlot.swap(sortedNodes);
+    needsSort = false;
+}
+
+// One pass in depth order: a node is dirty if it or its parent is (the parent's flag is already final), and the
+// dirty nodes of each depth level are multiplied as a batch once the level above is done.
+size_t TransformHierarchy::update()
+{
+    if (!anyDirty)
+    {
+        return 0; // Static scene: no work at all.
+    }
+    if (needsSort)
+    {
+        sortByDepth();
+    }
+
+    size_t updated = 0;
+    size_t count = parentSlots.size();
+    batch.clear();
+    for (size_t slot = 0; slot < count; slot++)
+    {
+        if (slot > 0 && depths[slot] != depths[slot - 1] && !batch.empty())
+        {
+            updateBatch(batch.data(), batch.size(), parentSlots.data(), locals.data(), worlds.data());
+            updated += batch.size();
+            batch.clear();
+        }
+
+        uint32_t parent = parentSlots[slot];
+        if (parent != TRANSFORM_NO_PARENT)
+        {
+            dirty[slot] |= dirty[parent];
+        }
+        if (dirty[slot])
+        {
+            batch.push_back(static_cast<uint32_t>(slot));
+        }
+    }
+    updateBatch(batch.data(), batch.size(), parentSlots.data(), locals.data(), worlds.data());
+    updated += batch.size();
+
+    std::fill(dirty.begin(), dirty.end(), 0);
+    anyDirty = false;
+    return updated;
+}
+
+void TransformHierarchy::clear()
+{
+    parentSlots.clear();
+    depths.clear();
+    locals.clear();
+    worlds.clear();
+    dirty.clear();
+    nodeOfSlot.clear();
+    slotOfNode.clear();
+    anyDirty = false;
+    needsSort = false;
+}
+
+#pragma endregion
@@ -0,0 +1,61 @@
+// transform_hierarchy.h
+#ifndef TRANSFORM_HIERARCHY_H
+#define TRANSFORM_HIERARCHY_H
+
+#include <cstddef>                  // Necessary for size_t
+#include <cstdint>                  // Necessary for uint32_t / uint8_t
+#include <vector>                   // For using std::vector dynamic arrays
+
+const uint32_t TRANSFORM_NO_PARENT = 0xFFFFFFFF; // Parent of root nodes.
+
+// A column-major 4x4 matrix, aligned for SIMD loads. Plain floats keep the interface independent of the GLM
+// configuration of each translation unit (glm::value_ptr / glm::make_mat4 convert).
+struct alignas(16) TransformMatrix
+{
+    float m[16];
+};
+
+// Flat scene transform hierarchy.
+// Nodes live in structure-of-arrays form (parent, local, world, dirty), sorted by depth so that every parent
+// precedes its children and each depth level can be multiplied as one batch. Changing a local matrix only marks
+// the node dirty; update() propagates the flag down and recomputes the world matrices of the changed subtrees
+// with SIMD multiplications. When nothing changed, update() returns immediately.
+class TransformHierarchy
+{
+public:
+    // Adds a node (a root if parent is TRANSFORM_NO_PARENT) and returns its handle. Handles stay valid while the
+    // storage is reordered by depth.
+    uint32_t addNode(uint32_t parent, const float local[16]);
+
+    // Replaces the local matrix (relative to the parent) and marks the subtree for update.
+    void setLocal(uint32_t node, const float local[16]);
+
+    // Recomputes the world matrices of dirty subtrees. Returns the number of world matrices computed.
+    size_t update();
+
+    // World matrix of a node as of the last update().
+    const float* getWorld(uint32_t node) const { return worlds[slotOfNode[node]].m; }
+
+    size_t getNodeCount() const { return parentSlots.size(); }
+
+    // Removes every node.
+    void clear();
+
+private:
+    void sortByDepth();
+
+    // Per slot (depth order).
+    std::vector<uint32_t> parentSlots;              // Slot of the parent, or TRANSFORM_NO_PARENT.
+    std::vector<uint32_t> depths;                   // 0 for roots.
+    std::vector<TransformMatrix> locals;            // Matrix relative to the parent.
+    std::vector<TransformMatrix> worlds;            // parent world * local.
+    std::vector<uint8_t> dirty;                     // Local changed (or an ancestor's did) since the last update.
+    std::vector<uint32_t> nodeOfSlot;               // Handle stored in each slot.
+
+    std::vector<uint32_t> slotOfNode;               // Current slot of each handle.
+    std::vector<uint32_t> batch;                    // Dirty slots of the depth level being updated.
+    bool anyDirty = false;                          // Set by setLocal / addNode; lets update() skip a static scene.
+    bool needsSort = false;                         // Nodes were added since the last update().
+};
+
+#endif // TRANSFORM_HIERARCHY_H
@@ -0,0 +1,83 @@
+// Region: Includes
+// This section includes the uniform ring header and the standard headers it needs.
+#pragma region Includes
+
+// uniform_ring.cpp
+#include "uniform_ring.h"          // Include the header file for this module
+
+#include <cstring>                  // For memcpy into the mapped arena
+#include <stdexcept>                // For standard exception handling (e.g., std::runtime_error)
+
+#pragma endregion
+
+// Region: Public Interface
+// This section implements creation of the arena and the per-frame entry allocation.
+#pragma region Public Interface
+
+// Creates and maps the arena buffer.
+void UniformRing::init(VkPhysicalDevice physicalDevice, VkDevice logicalDevice, DeviceMemoryAllocator* memoryAllocator,
+                       VkDeviceSize size, uint32_t maxElements, uint32_t frames)
+{
+    device = logicalDevice;
+    allocator = memoryAllocator;
+    elementSize = size;
+    maxElementsPerFrame = maxElements;
+    frameCount = frames;
+
+    // Dynamic offsets must be multiples of minUniformBufferOffsetAlignment (a power of two).
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    VkDeviceSize alignment = properties.limits.minUniformBufferOffsetAlignment;
+    stride = (elementSize + alignment - 1) & ~(alignment - 1);
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = stride * maxElementsPerFrame * frameCount;
+    bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT; // Storage: also read through bindless descriptors.
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create uniform ring buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+    allocation = allocator->allocate(memRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, MemoryTag::Uniform);
+    vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset);
+
+    currentFrame = 0;
+    elementCount = 0;
+}
+
+// Destroys the arena buffer.
+void UniformRing::cleanup()
+{
+    vkDestroyBuffer(device, buffer, nullptr);
+    allocator->free(allocation);
+    buffer = VK_NULL_HANDLE;
+}
+
+// Rewinds to the first entry of a frame slot.
+void UniformRing::beginFrame(uint32_t frameIndex)
+{
+    currentFrame = frameIndex % frameCount;
+    elementCount = 0;
+}
+
+// Writes the next entry and returns its dynamic offset.
+uint32_t UniformRing::push(const void* data)
+{
+    if (elementCount == maxElementsPerFrame)
+    {
+        throw std::runtime_error("uniform ring is full!");
+    }
+
+    VkDeviceSize offset = (static_cast<VkDeviceSize>(currentFrame) * maxElementsPerFrame + elementCount) * stride;
+    memcpy(static_cast<char*>(allocation.mappedData) + offset, data, static_cast<size_t>(elementSize));
+    elementCount++;
+
+    return static_cast<uint32_t>(offset);
+}
+
+#pragma endregion
@@ -0,0 +1,52 @@
+// uniform_ring.h
+#ifndef UNIFORM_RING_H
+#define UNIFORM_RING_H
+
+#include "memory_allocator.h"       // The arena memory comes from the sub-allocator
+#include <vulkan/vulkan.h>          // Vulkan types (VkBuffer, VkDeviceSize, ...)
+#include <cstdint>                  // Necessary for uint32_t
+
+// One persistently mapped uniform buffer shared by every object of every frame in flight.
+// The buffer holds frameCount regions of maxElementsPerFrame entries, each padded to minUniformBufferOffsetAlignment.
+// It is bound through a single VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC descriptor; push() returns the dynamic
+// offset that selects an entry at vkCmdBindDescriptorSets time. A region is only rewritten after beginFrame of the
+// same frame slot, i.e. after the in-flight fence of that slot has been waited on.
+class UniformRing
+{
+public:
+    // Creates and maps the arena for elements of elementSize bytes.
+    void init(VkPhysicalDevice physicalDevice, VkDevice device, DeviceMemoryAllocator* allocator,
+              VkDeviceSize elementSize, uint32_t maxElementsPerFrame, uint32_t frameCount);
+
+    // Destroys the arena buffer and returns its memory to the allocator.
+    void cleanup();
+
+    // Starts writing the region of a frame slot from its first entry.
+    void beginFrame(uint32_t frameIndex);
+
+    // Copies one element into the next entry of the current region and returns its dynamic offset.
+    uint32_t push(const void* data);
+
+    // Buffer to write into the dynamic descriptor.
+    VkBuffer getBuffer() const { return buffer; }
+
+    // Range of one element (the descriptor range).
+    VkDeviceSize getElementSize() const { return elementSize; }
+
+    // Distance in bytes between two consecutive entries.
+    VkDeviceSize getStride() const { return stride; }
+
+private:
+    VkDevice device = VK_NULL_HANDLE;                   // Logical device.
+    DeviceMemoryAllocator* allocator = nullptr;         // Allocator the arena memory was taken from.
+    VkBuffer buffer = VK_NULL_HANDLE;                   // The arena buffer.
+    MemoryAllocation allocation = {};                   // Memory backing the arena (persistently mapped).
+    VkDeviceSize elementSize = 0;                       // Size of one element.
+    VkDeviceSize stride = 0;                            // elementSize rounded up to minUniformBufferOffsetAlignment.
+    uint32_t maxElementsPerFrame = 0;                   // Capacity of one region.
+    uint32_t frameCount = 0;                            // Number of regions.
+    uint32_t currentFrame = 0;                          // Region being written.
+    uint32_t elementCount = 0;                          // Entries written to the current region.
+};
+
+#endif // UNIFORM_RING_H
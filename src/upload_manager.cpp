@@ -0,0 +1,260 @@
+// Region: Includes
+// This section includes the upload manager header and the standard headers it needs.
+#pragma region Includes
+
+// upload_manager.cpp
+#include "upload_manager.h"        // Include the header file for this module
+
+#include <cstring>                  // For memcpy into the staging memory
+#include <stdexcept>                // For standard exception handling (e.g., std::runtime_error)
+
+#pragma endregion
+
+// Region: Public Interface
+// This section implements batching, submission and completion tracking of uploads.
+#pragma region Public Interface
+
+// Creates the command pool used by the upload batches.
+void UploadManager::init(VkDevice logicalDevice, DeviceMemoryAllocator* memoryAllocator, uint32_t familyIndex, VkQueue uploadQueue,
+                         VkDeviceSize ringSize)
+{
+    device = logicalDevice;
+    allocator = memoryAllocator;
+    queueFamilyIndex = familyIndex;
+    queue = uploadQueue;
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT; // Short-lived, individually reset buffers.
+    poolInfo.queueFamilyIndex = queueFamilyIndex; // Use the upload queue family index.
+
+    if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create upload command pool!");
+    }
+
+    stagingRing.init(device, allocator, ringSize);
+}
+
+// Waits for the batches in flight and destroys every object owned by the manager.
+void UploadManager::cleanup()
+{
+    // Anything still open is submitted so its staging memory is released through the normal path.
+    submit();
+
+    while (!pendingBatches.empty())
+    {
+        vkWaitForFences(device, 1, &pendingBatches.front().fence, VK_TRUE, UINT64_MAX);
+        collect();
+    }
+
+    for (auto& batch : freeBatches)
+    {
+        vkDestroyFence(device, batch.fence, nullptr);
+    }
+    freeBatches.clear();
+
+    vkDestroyCommandPool(device, commandPool, nullptr); // Also frees the command buffers allocated from it.
+    commandPool = VK_NULL_HANDLE;
+
+    stagingRing.cleanup();
+}
+
+// Stages host data and records a copy into the destination buffer.
+void UploadManager::enqueueBufferUpload(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size)
+{
+    memcpy(reserveBufferUpload(dstBuffer, dstOffset, size), data, static_cast<size_t>(size)); // Copy the data through the persistent mapping.
+}
+
+// Takes staging memory for the upload and records its copy; the caller fills the memory before submit().
+void* UploadManager::reserveBufferUpload(VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize size)
+{
+    if (!batchOpen)
+    {
+        beginBatch();
+    }
+
+    VkBufferCopy copyRegion{};
+    copyRegion.dstOffset = dstOffset;
+    copyRegion.size = size;
+
+    // Common case: a slice of the ring. When it is full, wait for the oldest batch still reading it and retry.
+    if (size <= stagingRing.getSize())
+    {
+        StagingSlice slice;
+        while (!stagingRing.allocate(size, 16, nextTicket, slice)) // The open batch gets the next ticket on submit.
+        {
+            UploadTicket oldest = stagingRing.getOldestTicket();
+            if (oldest == nextTicket)
+            {
+                submit(); // Only the open batch reads the ring; send it before waiting on it.
+            }
+            wait(oldest); // Retires the batch, which releases its span of the ring.
+        }
+
+        if (!batchOpen)
+        {
+            beginBatch(); // The batch was submitted while waiting for space.
+        }
+
+        copyRegion.srcOffset = slice.offset;
+        vkCmdCopyBuffer(openBatch.commandBuffer, slice.buffer, dstBuffer, 1, &copyRegion);
+        return slice.mappedData;
+    }
+
+    // The upload is larger than the whole ring: fall back to a dedicated host-visible staging buffer.
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // Only the upload queue reads it.
+
+    VkBuffer stagingBuffer = VK_NULL_HANDLE;
+    if (vkCreateBuffer(device, &bufferInfo, nullptr, &stagingBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create staging buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device, stagingBuffer, &memRequirements);
+    MemoryAllocation stagingAllocation = allocator->allocate(memRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, MemoryTag::Staging);
+    vkBindBufferMemory(device, stagingBuffer, stagingAllocation.memory, stagingAllocation.offset);
+
+    // Record the copy into the open batch.
+    copyRegion.srcOffset = 0;
+    vkCmdCopyBuffer(openBatch.commandBuffer, stagingBuffer, dstBuffer, 1, &copyRegion);
+
+    openBatch.stagingBuffers.push_back(stagingBuffer);
+    openBatch.stagingAllocations.push_back(stagingAllocation);
+    return stagingAllocation.mappedData;
+}
+
+// Ends and submits the open batch, returning the ticket that identifies it.
+UploadTicket UploadManager::submit()
+{
+    if (!batchOpen)
+    {
+        return nextTicket - 1; // Nothing new: the last submitted batch covers everything enqueued so far.
+    }
+
+    if (vkEndCommandBuffer(openBatch.commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to record upload command buffer!");
+    }
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &openBatch.commandBuffer;
+
+    // The fence is the only synchronization: the host polls it instead of idling the queue.
+    if (vkQueueSubmit(queue, 1, &submitInfo, openBatch.fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to submit upload command buffer!");
+    }
+
+    openBatch.ticket = nextTicket++;
+    UploadTicket ticket = openBatch.ticket;
+    pendingBatches.push_back(std::move(openBatch));
+    openBatch = UploadBatch{};
+    batchOpen = false;
+
+    return ticket;
+}
+
+// Checks, without blocking, whether a batch has finished.
+bool UploadManager::isComplete(UploadTicket ticket)
+{
+    collect();
+    return ticket <= completedTicket;
+}
+
+// Blocks until a batch has finished.
+void UploadManager::wait(UploadTicket ticket)
+{
+    while (!isComplete(ticket) && !pendingBatches.empty())
+    {
+        vkWaitForFences(device, 1, &pendingBatches.front().fence, VK_TRUE, UINT64_MAX);
+    }
+}
+
+// Retires the batches whose fence has signaled, oldest first.
+void UploadManager::collect()
+{
+    while (!pendingBatches.empty() && vkGetFenceStatus(device, pendingBatches.front().fence) == VK_SUCCESS)
+    {
+        UploadBatch batch = std::move(pendingBatches.front());
+        pendingBatches.pop_front();
+
+        completedTicket = batch.ticket;
+        retireBatch(batch);
+    }
+    stagingRing.release(completedTicket);
+}
+
+#pragma endregion
+
+// Region: Batch Management
+// This section implements opening and recycling of upload batches.
+#pragma region Batch Management
+
+// Starts recording a new batch, reusing a retired command buffer and fence when possible.
+void UploadManager::beginBatch()
+{
+    if (!freeBatches.empty())
+    {
+        openBatch = std::move(freeBatches.back());
+        freeBatches.pop_back();
+        vkResetFences(device, 1, &openBatch.fence);
+        vkResetCommandBuffer(openBatch.commandBuffer, 0);
+    }
+    else
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = commandPool;
+        allocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(device, &allocInfo, &openBatch.commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate upload command buffer!");
+        }
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        if (vkCreateFence(device, &fenceInfo, nullptr, &openBatch.fence) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create upload fence!");
+        }
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT; // Each recording is submitted exactly once.
+
+    if (vkBeginCommandBuffer(openBatch.commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to begin recording upload command buffer!");
+    }
+
+    batchOpen = true;
+}
+
+// Frees the dedicated staging memory of a finished batch and keeps its command buffer and fence for reuse.
+void UploadManager::retireBatch(UploadBatch& batch)
+{
+    for (size_t i = 0; i < batch.stagingBuffers.size(); i++)
+    {
+        vkDestroyBuffer(device, batch.stagingBuffers[i], nullptr);
+        allocator->free(batch.stagingAllocations[i]);
+    }
+    batch.stagingBuffers.clear();
+    batch.stagingAllocations.clear();
+    batch.ticket = 0;
+
+    freeBatches.push_back(std::move(batch));
+}
+
+#pragma endregion
@@ -0,0 +1,83 @@
+// upload_manager.h
+#ifndef UPLOAD_MANAGER_H
+#define UPLOAD_MANAGER_H
+
+#include "memory_allocator.h"       // Staging memory comes from the sub-allocator
+#include "staging_ring.h"           // Persistently mapped staging ring used by most uploads
+#include <vulkan/vulkan.h>          // Vulkan types (VkQueue, VkCommandBuffer, VkFence, ...)
+#include <cstdint>                  // Necessary for uint64_t
+#include <deque>                    // For the queue of submitted batches
+#include <vector>                   // For using std::vector dynamic arrays
+
+// Identifies a submitted upload batch. Tickets grow monotonically; 0 means "nothing was uploaded".
+typedef uint64_t UploadTicket;
+
+// Asynchronous batched upload service.
+// Uploads are staged into host-visible memory and recorded into one open command buffer; submit() sends the
+// whole batch to the transfer queue with a fence and returns a ticket that callers can poll or wait on.
+// Staging space is bump-allocated from a persistent ring, so an upload costs a memcpy and a copy region. The ring wraps
+// around over the spans of finished batches; when it is full the upload waits for the oldest batch still reading it.
+// Only uploads larger than the whole ring get a dedicated staging buffer, freed when the batch fence signals.
+class UploadManager
+{
+public:
+    // Creates the command pool on the given queue family and the staging ring of ringSize bytes.
+    // The queue should be a dedicated transfer queue when available.
+    void init(VkDevice device, DeviceMemoryAllocator* allocator, uint32_t queueFamilyIndex, VkQueue queue,
+              VkDeviceSize ringSize = 8ull * 1024 * 1024);
+
+    // Waits for the batches still in flight and destroys every Vulkan object owned by the manager.
+    void cleanup();
+
+    // Copies `size` bytes of host data into dstBuffer at dstOffset as part of the open batch.
+    // dstBuffer must have VK_BUFFER_USAGE_TRANSFER_DST_BIT and be accessible from the upload queue family.
+    void enqueueBufferUpload(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size);
+
+    // Like enqueueBufferUpload, but returns the `size` bytes of mapped staging memory the copy reads from instead of
+    // copying host data into them. The caller writes the data there (e.g. converts it in place) before submit().
+    void* reserveBufferUpload(VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize size);
+
+    // Submits the open batch and returns its ticket, or the ticket of the last batch if nothing was enqueued.
+    UploadTicket submit();
+
+    // Returns true once the batch identified by the ticket has finished on the GPU. Never blocks.
+    bool isComplete(UploadTicket ticket);
+
+    // Blocks until the batch identified by the ticket has finished on the GPU.
+    void wait(UploadTicket ticket);
+
+    // Retires finished batches: frees their staging memory and recycles their command buffer and fence.
+    void collect();
+
+    // Queue family the uploads are executed on.
+    uint32_t getQueueFamilyIndex() const { return queueFamilyIndex; }
+
+private:
+    // A command buffer with its fence and the staging buffers it reads from.
+    struct UploadBatch
+    {
+        UploadTicket ticket = 0;                                // Ticket returned by submit().
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;         // Command buffer holding the copies.
+        VkFence fence = VK_NULL_HANDLE;                         // Signaled when the batch has finished.
+        std::vector<VkBuffer> stagingBuffers;                   // Dedicated staging buffers read by the copies (oversized uploads).
+        std::vector<MemoryAllocation> stagingAllocations;       // Memory of the dedicated staging buffers.
+    };
+
+    void beginBatch();
+    void retireBatch(UploadBatch& batch);
+
+    VkDevice device = VK_NULL_HANDLE;                   // Logical device.
+    DeviceMemoryAllocator* allocator = nullptr;         // Allocator for the staging buffers.
+    uint32_t queueFamilyIndex = 0;                      // Queue family of the upload queue.
+    VkQueue queue = VK_NULL_HANDLE;                     // Queue the batches are submitted to.
+    VkCommandPool commandPool = VK_NULL_HANDLE;         // Pool for the batch command buffers.
+    StagingRing stagingRing;                            // Staging memory of every upload that fits in it.
+    bool batchOpen = false;                             // True while openBatch is recording.
+    UploadBatch openBatch;                              // Batch that collects the next copies.
+    std::deque<UploadBatch> pendingBatches;             // Submitted batches, oldest first.
+    std::vector<UploadBatch> freeBatches;               // Retired batches whose command buffer and fence can be reused.
+    UploadTicket nextTicket = 1;                        // Ticket of the next submitted batch.
+    UploadTicket completedTicket = 0;                   // Every batch up to this ticket has finished.
+};
+
+#endif // UPLOAD_MANAGER_H
@@ -0,0 +1,291 @@
+// Region: Includes
+// This section includes the vertex format header and the standard headers it needs.
+#pragma region Includes
+
+// vertex_format.cpp
+#include "vertex_format.h"         // Include the header file for this module
+
+#include <algorithm>                // For std::clamp / std::max
+#include <cmath>                    // For std::fabs / std::lround
+#include <cstring>                  // For memcpy of packed attributes and float bits
+
+#pragma endregion
+
+// Region: Layout
+// This section derives offsets, sizes and Vulkan formats from the encodings.
+#pragma region Layout
+
+// Bytes taken by the position.
+static uint32_t getPositionSize(PositionEncoding encoding)
+{
+    return encoding == PositionEncoding::Float32 ? 8 : 4;
+}
+
+// Bytes taken by the color.
+static uint32_t getColorSize(ColorEncoding encoding)
+{
+    return encoding == ColorEncoding::Float32 ? 12 : 4;
+}
+
+// Bytes taken by the normal.
+static uint32_t getNormalSize(NormalEncoding encoding)
+{
+    switch (encoding)
+    {
+        case NormalEncoding::Float32:      return 12;
+        case NormalEncoding::Octahedral16: return 4;
+        default:                           return 0;
+    }
+}
+
+static VkFormat getPositionFormat(PositionEncoding encoding)
+{
+    switch (encoding)
+    {
+        case PositionEncoding::Half16:  return VK_FORMAT_R16G16_SFLOAT;
+        case PositionEncoding::Snorm16: return VK_FORMAT_R16G16_SNORM;
+        default:                        return VK_FORMAT_R32G32_SFLOAT;
+    }
+}
+
+static VkFormat getColorFormat(ColorEncoding encoding)
+{
+    return encoding == ColorEncoding::Unorm8 ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R32G32B32_SFLOAT;
+}
+
+static VkFormat getNormalFormat(NormalEncoding encoding)
+{
+    return encoding == NormalEncoding::Octahedral16 ? VK_FORMAT_R16G16_SNORM : VK_FORMAT_R32G32B32_SFLOAT;
+}
+
+uint32_t VertexFormat::getColorOffset() const
+{
+    return getPositionSize(position);
+}
+
+uint32_t VertexFormat::getNormalOffset() const
+{
+    return getColorOffset() + getColorSize(color);
+}
+
+uint32_t VertexFormat::getStride() const
+{
+    return getNormalOffset() + getNormalSize(normal);
+}
+
+// Appends one description per attribute, at the fixed shader locations.
+void VertexFormat::appendAttributes(std::vector<VkVertexInputAttributeDescription>& attributes, uint32_t binding) const
+{
+    VkVertexInputAttributeDescription attribute{};
+    attribute.binding = binding;
+
+    attribute.location = VERTEX_POSITION_LOCATION;
+    attribute.format = getPositionFormat(position);
+    attribute.offset = 0;
+    attributes.push_back(attribute);
+
+    attribute.location = VERTEX_COLOR_LOCATION;
+    attribute.format = getColorFormat(color);
+    attribute.offset = getColorOffset();
+    attributes.push_back(attribute);
+
+    if (normal != NormalEncoding::None)
+    {
+        attribute.location = VERTEX_NORMAL_LOCATION;
+        attribute.format = getNormalFormat(normal);
+        attribute.offset = getNormalOffset();
+        attributes.push_back(attribute);
+    }
+}
+
+// Checks VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT for every attribute format.
+bool VertexFormat::isSupported(VkPhysicalDevice physicalDevice) const
+{
+    std::vector<VkVertexInputAttributeDescription> attributes;
+    appendAttributes(attributes, 0);
+    for (const auto& attribute : attributes)
+    {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, attribute.format, &properties);
+        if (!(properties.bufferFeatures & VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const char* VertexFormat::getName() const
+{
+    if (position == PositionEncoding::Float32 && color == ColorEncoding::Float32)
+    {
+        return "float32";
+    }
+    if (position == PositionEncoding::Half16)
+    {
+        return color == ColorEncoding::Unorm8 ? "half + unorm8" : "half + float32";
+    }
+    if (position == PositionEncoding::Snorm16)
+    {
+        return color == ColorEncoding::Unorm8 ? "snorm16 + unorm8" : "snorm16 + float32";
+    }
+    return "float32 + unorm8";
+}
+
+#pragma endregion
+
+// Region: Conversion Kernels
+// This section converts float attributes to their compact encodings.
+#pragma region Conversion Kernels
+
+// IEEE 754 binary32 -> binary16 with round to nearest even. Values too small for a subnormal become zero.
+uint16_t floatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t floatExponent = (bits >> 23) & 0xff;
+    uint32_t mantissa = bits & 0x7fffff;
+    int32_t exponent = static_cast<int32_t>(floatExponent) - 127 + 15;
+
+    if (floatExponent == 0xff)
+    {
+        return static_cast<uint16_t>(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0)); // Infinity or NaN.
+    }
+    if (exponent >= 31)
+    {
+        return static_cast<uint16_t>(sign | 0x7c00); // Overflow to infinity.
+    }
+    if (exponent <= 0)
+    {
+        if (exponent < -10)
+        {
+            return static_cast<uint16_t>(sign); // Below the smallest subnormal.
+        }
+        mantissa |= 0x800000; // Make the implicit leading bit explicit.
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1)))
+        {
+            half++;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+    {
+        half++; // A carry into the exponent is still the correctly rounded value.
+    }
+    return static_cast<uint16_t>(half);
+}
+
+int16_t floatToSnorm16(float value)
+{
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+uint8_t floatToUnorm8(float value)
+{
+    return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+// Projects the unit sphere onto the octahedron |x| + |y| + |z| = 1 and unfolds the lower half over the corners.
+// Decode in GLSL: vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y)); float t = max(-n.z, 0.0);
+//                 n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0))); n = normalize(n);
+void encodeOctahedral(const float normal[3], int16_t encoded[2])
+{
+    float length = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+    float x = length > 0.0f ? normal[0] / length : 0.0f;
+    float y = length > 0.0f ? normal[1] / length : 0.0f;
+    if (normal[2] < 0.0f)
+    {
+        float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = foldedX;
+        y = foldedY;
+    }
+    encoded[0] = floatToSnorm16(x);
+    encoded[1] = floatToSnorm16(y);
+}
+
+// Finds the scale that maps every position component into [-1, 1].
+float computePositionScale(const VertexStreams& streams)
+{
+    float scale = 1e-6f;
+    for (size_t i = 0; i < streams.count; i++)
+    {
+        const float* position = reinterpret_cast<const float*>(reinterpret_cast<const char*>(streams.positions) + i * streams.positionStride);
+        scale = std::max(scale, std::max(std::fabs(position[0]), std::fabs(position[1])));
+    }
+    return scale;
+}
+
+// Converts vertex by vertex; each attribute is assembled on the stack and copied (the output has no alignment guarantee).
+void packVertices(const VertexFormat& format, const VertexStreams& streams, float positionScale, void* destination)
+{
+    const uint32_t stride = format.getStride();
+    const uint32_t colorOffset = format.getColorOffset();
+    const uint32_t normalOffset = format.getNormalOffset();
+    const float inverseScale = 1.0f / positionScale;
+
+    char* output = static_cast<char*>(destination);
+    for (size_t i = 0; i < streams.count; i++, output += stride)
+    {
+        const float* position = reinterpret_cast<const float*>(reinterpret_cast<const char*>(streams.positions) + i * streams.positionStride);
+        const float* color = reinterpret_cast<const float*>(reinterpret_cast<const char*>(streams.colors) + i * streams.colorStride);
+
+        switch (format.position)
+        {
+            case PositionEncoding::Float32:
+                memcpy(output, position, 8);
+                break;
+            case PositionEncoding::Half16:
+            {
+                uint16_t packed[2] = {floatToHalf(position[0]), floatToHalf(position[1])};
+                memcpy(output, packed, sizeof(packed));
+                break;
+            }
+            case PositionEncoding::Snorm16:
+            {
+                int16_t packed[2] = {floatToSnorm16(position[0] * inverseScale), floatToSnorm16(position[1] * inverseScale)};
+                memcpy(output, packed, sizeof(packed));
+                break;
+            }
+        }
+
+        if (format.color == ColorEncoding::Float32)
+        {
+            memcpy(output + colorOffset, color, 12);
+        }
+        else
+        {
+            uint8_t packed[4] = {floatToUnorm8(color[0]), floatToUnorm8(color[1]), floatToUnorm8(color[2]), 255};
+            memcpy(output + colorOffset, packed, sizeof(packed));
+        }
+
+        if (format.normal != NormalEncoding::None)
+        {
+            static const float up[3] = {0.0f, 0.0f, 1.0f}; // Meshes without normals face +Z.
+            const float* normal = streams.normals != nullptr
+                ? reinterpret_cast<const float*>(reinterpret_cast<const char*>(streams.normals) + i * streams.normalStride)
+                : up;
+            if (format.normal == NormalEncoding::Float32)
+            {
+                memcpy(output + normalOffset, normal, 12);
+            }
+            else
+            {
+                int16_t packed[2];
+                encodeOctahedral(normal, packed);
+                memcpy(output + normalOffset, packed, sizeof(packed));
+            }
+        }
+    }
+}
+
+#pragma endregion
@@ -0,0 +1,84 @@
+// vertex_format.h
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <vulkan/vulkan.h>          // Vulkan types (VkFormat, VkVertexInputAttributeDescription, ...)
+#include <cstddef>                  // Necessary for size_t
+#include <cstdint>                  // Necessary for uint16_t / int16_t / uint8_t
+#include <vector>                   // For using std::vector dynamic arrays
+
+// Shader locations of the vertex attributes (2 and 3 are taken by the per-instance attributes).
+const uint32_t VERTEX_POSITION_LOCATION = 0;
+const uint32_t VERTEX_COLOR_LOCATION = 1;
+const uint32_t VERTEX_NORMAL_LOCATION = 4;
+
+// Encoding of the 2D position.
+enum class PositionEncoding : uint32_t
+{
+    Float32,                        // R32G32_SFLOAT, 8 bytes.
+    Half16,                         // R16G16_SFLOAT, 4 bytes (about 3 decimal digits).
+    Snorm16                         // R16G16_SNORM, 4 bytes; the shader multiplies by the position scale.
+};
+
+// Encoding of the RGB color.
+enum class ColorEncoding : uint32_t
+{
+    Float32,                        // R32G32B32_SFLOAT, 12 bytes.
+    Unorm8                          // R8G8B8A8_UNORM, 4 bytes (alpha = 1).
+};
+
+// Encoding of the unit normal.
+enum class NormalEncoding : uint32_t
+{
+    None,                           // No normal attribute.
+    Float32,                        // R32G32B32_SFLOAT, 12 bytes.
+    Octahedral16                    // R16G16_SNORM, 4 bytes, octahedral mapping (decoded in the shader).
+};
+
+// A vertex layout built from per-attribute encodings. Attributes are packed in the order position, color,
+// normal, each on a 4-byte boundary, in a single interleaved binding.
+struct VertexFormat
+{
+    PositionEncoding position = PositionEncoding::Float32;
+    ColorEncoding color = ColorEncoding::Float32;
+    NormalEncoding normal = NormalEncoding::None;
+
+    uint32_t getColorOffset() const;
+    uint32_t getNormalOffset() const;
+    uint32_t getStride() const;
+
+    // Appends the attribute descriptions of this layout for the given binding.
+    void appendAttributes(std::vector<VkVertexInputAttributeDescription>& attributes, uint32_t binding) const;
+
+    // True if every attribute format can be used as a vertex buffer on the device.
+    bool isSupported(VkPhysicalDevice physicalDevice) const;
+
+    // Short description for logs and the window title (e.g. "half + unorm8").
+    const char* getName() const;
+};
+
+// Source attribute streams for packVertices. Strides are in bytes, so interleaved arrays can be read in place.
+struct VertexStreams
+{
+    size_t count = 0;                       // Number of vertices.
+    const float* positions = nullptr;       // 2 floats per vertex.
+    size_t positionStride = 0;
+    const float* colors = nullptr;          // 3 floats per vertex.
+    size_t colorStride = 0;
+    const float* normals = nullptr;         // 3 floats per vertex (unit length), or nullptr.
+    size_t normalStride = 0;
+};
+
+// Largest absolute position component (at least 1e-6); snorm16 positions are stored divided by it.
+float computePositionScale(const VertexStreams& streams);
+
+// Converts the streams to the format, writing count * format.getStride() bytes to destination.
+void packVertices(const VertexFormat& format, const VertexStreams& streams, float positionScale, void* destination);
+
+// Scalar conversion kernels used by packVertices.
+uint16_t floatToHalf(float value);                                  // Round to nearest even, overflow to infinity.
+int16_t floatToSnorm16(float value);                                // [-1, 1] -> [-32767, 32767].
+uint8_t floatToUnorm8(float value);                                 // [0, 1] -> [0, 255].
+void encodeOctahedral(const float normal[3], int16_t encoded[2]);   // Unit vector -> 2 x snorm16.
+
+#endif // VERTEX_FORMAT_H
@@ -0,0 +1,93 @@
+// Region: Includes
+// This section includes the mesh file and mesh optimizer modules shared with the sandbox.
+#pragma region Includes
+
+// cook_mesh.cpp
+// Offline cook step for mesh files: reads a mesh written by scripts/make_mesh.py, reorders it for the vertex cache,
+// overdraw and vertex fetch, and writes it back with MESH_FLAG_OPTIMIZED so the sandbox uploads it straight from the mapping.
+// Usage: cook_mesh <input.bin> <output.bin> (the output may be the input file)
+#include "mesh_file.h"              // Reading and writing the mesh container
+#include "mesh_optimizer.h"         // Vertex cache / overdraw / vertex fetch reordering
+
+#include <chrono>                   // For timing the optimization
+#include <cstdlib>                  // For EXIT_SUCCESS / EXIT_FAILURE
+#include <cstring>                  // For memcpy of the vertex blob
+#include <iostream>                 // For the usage and the statistics
+#include <vector>                   // For using std::vector dynamic arrays
+
+#pragma endregion
+
+// Region: Cook
+// This section copies the mesh out of the mapping, runs the optimizer passes and writes the result.
+#pragma region Cook
+
+// Order of the passes: deduplication first, then triangles for the cache, clusters for overdraw, and finally
+// the vertices in the order the triangles now read them.
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: cook_mesh <input.bin> <output.bin>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    MeshFile input;
+    if (!input.open(argv[1]))
+    {
+        return EXIT_FAILURE;
+    }
+
+    MeshFileHeader header = input.getHeader();
+    if (header.vertexFormat != MESH_VERTEX_FORMAT_POS2_COLOR3 || header.vertexStride != 5 * sizeof(float))
+    {
+        std::cerr << "cook_mesh: " << argv[1] << " has vertex format " << header.vertexFormat << ", only "
+                  << MESH_VERTEX_FORMAT_POS2_COLOR3 << " (position + color) is supported" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // The passes work on a writable copy with 32-bit indices; the mapping is closed before the output is written,
+    // since the output may replace the input.
+    std::vector<float> vertices(header.vertexBytes / sizeof(float));
+    memcpy(vertices.data(), input.getVertexData(), static_cast<size_t>(header.vertexBytes));
+    std::vector<uint32_t> indices(header.indexCount);
+    for (uint32_t i = 0; i < header.indexCount; i++)
+    {
+        indices[i] = header.indexSize == 4 ? static_cast<const uint32_t*>(input.getIndexData())[i] : static_cast<const uint16_t*>(input.getIndexData())[i];
+    }
+    input.close();
+
+    auto optimizeStart = std::chrono::high_resolution_clock::now();
+    size_t vertexCount = header.vertexCount;
+    MeshStatistics before = analyzeMesh(indices.data(), indices.size(), vertexCount, header.vertexStride);
+
+    vertexCount = deduplicateVertices(vertices.data(), vertexCount, header.vertexStride, indices.data(), indices.size());
+    optimizeVertexCache(indices.data(), indices.size(), vertexCount);
+    optimizeOverdraw(indices.data(), indices.size(), vertices.data(), header.vertexStride, 2, vertexCount); // Position: the first two floats.
+    vertexCount = optimizeVertexFetch(vertices.data(), vertexCount, header.vertexStride, indices.data(), indices.size());
+
+    MeshStatistics after = analyzeMesh(indices.data(), indices.size(), vertexCount, header.vertexStride);
+    double optimizeMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - optimizeStart).count();
+
+    // Narrow the indices back to 16 bits when the remaining vertices allow it.
+    header.vertexCount = static_cast<uint32_t>(vertexCount);
+    header.indexSize = vertexCount <= 0x10000 ? 2 : 4;
+    header.flags |= MESH_FLAG_OPTIMIZED;
+    std::vector<uint16_t> narrowIndices;
+    if (header.indexSize == 2)
+    {
+        narrowIndices.assign(indices.begin(), indices.end());
+    }
+
+    if (!MeshFile::write(argv[2], header, vertices.data(), header.indexSize == 2 ? static_cast<const void*>(narrowIndices.data()) : indices.data()))
+    {
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Mesh optimized in " << optimizeMilliseconds << " ms: " << before.vertexCount << " -> " << after.vertexCount << " vertices, ACMR "
+              << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr << " -> " << after.atvr << ", overfetch "
+              << before.overfetch << " -> " << after.overfetch << std::endl;
+    std::cout << "Wrote " << argv[2] << ": " << header.vertexCount << " vertices, " << header.indexCount << " " << header.indexSize * 8 << "-bit indices" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+#pragma endregion